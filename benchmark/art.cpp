@@ -0,0 +1,175 @@
+#include "ART.hpp"
+#include "BTree.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+#ifndef NDEBUG
+constexpr std::size_t num_entries = 1e6;
+constexpr std::size_t num_point_lookups = 1e4;
+#else
+constexpr std::size_t num_entries = 1e7;
+constexpr std::size_t num_point_lookups = 1e6;
+#endif
+
+using char32 = std::array<char, 32>; // `CHAR(32)`
+
+
+/** Generates \p count sorted integer keys with gaps and repetitions, like the `milestone2` benchmark. */
+template<typename Key, typename Generator>
+std::vector<Key> gen_data(std::size_t count, Generator &g)
+{
+    std::vector<Key> vec;
+    vec.reserve(count);
+    std::uniform_int_distribution<> dist_repetition(1, 10);
+    std::uniform_int_distribution<> dist_gap(1, 10);
+    Key current = 0;
+    while (vec.size() != count) {
+        current += dist_gap(g);
+        for (std::size_t n = dist_repetition(g); n and vec.size() != count; --n)
+            vec.emplace_back(current);
+    }
+    return vec;
+}
+
+/** Reads the values of column \p column of the CSV file \p filename, truncated and padded to `CHAR(32)`, into \p
+ * values.  Returns `false` if the file cannot be read or has no rows. */
+bool read_column(const char *filename, std::size_t column, std::vector<char32> &values)
+{
+    values.clear();
+    std::ifstream in(filename);
+    std::string line;
+    if (not std::getline(in, line)) return false; // skip header
+    while (std::getline(in, line)) {
+        /* Split at commas outside of double quotes. */
+        std::size_t field = 0;
+        bool quoted = false;
+        std::string value;
+        for (char c : line) {
+            if (c == '"') quoted = not quoted;
+            else if (c == ',' and not quoted) ++field;
+            else if (field == column) value += c;
+        }
+        char32 key{};
+        std::copy_n(value.begin(), std::min(value.size(), key.size()), key.begin());
+        values.push_back(key);
+    }
+    return not values.empty();
+}
+
+template<typename Index, typename Key>
+void benchmark(const char *name, const std::vector<std::pair<Key, int32_t>> &data,
+               const std::vector<Key> &lookup_keys)
+{
+    using namespace std::chrono;
+
+    /*----- Bulkload data. -----*/
+    const auto t_bulkload_begin = steady_clock::now();
+    const auto index = Index::Bulkload(data.cbegin(), data.cend());
+    const auto t_bulkload_end = steady_clock::now();
+
+    std::cout << "art,bulkload_" << name << ','
+              << duration_cast<milliseconds>(t_bulkload_end - t_bulkload_begin).count()
+              << '\n';
+
+    /*----- Benchmark `find()`. -----*/
+    uint64_t checksum = 0;
+    const auto t_lookup_begin = steady_clock::now();
+    for (auto &k : lookup_keys) {
+        const auto it = index.find(k);
+        const uint64_t v = (it == index.cend()) ? 1UL : (*it).second();
+        checksum = (checksum << 3UL) ^ v;
+    }
+    const auto t_lookup_end = steady_clock::now();
+
+    const auto ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+    std::cout << "art,find_" << name << ','
+              << std::round(ns / double(lookup_keys.size())) << ','
+              << std::hex << checksum << std::dec
+              << '\n';
+}
+
+/** Benchmarks `BTree`s with different node sizes against the `ART` on the sorted \p data. */
+template<typename Key>
+void benchmark_indexes(const std::string &name, const std::vector<std::pair<Key, int32_t>> &data,
+                       const std::vector<Key> &lookup_keys)
+{
+    benchmark<BTree<Key, int32_t, 512>>((name + "_btree_512").c_str(), data, lookup_keys);
+    benchmark<BTree<Key, int32_t, 4096>>((name + "_btree_4096").c_str(), data, lookup_keys);
+    benchmark<ART<Key, int32_t>>((name + "_art").c_str(), data, lookup_keys);
+}
+
+template<typename Key, typename Generator>
+void benchmark_integers(const char *name, Generator g)
+{
+    const auto keys = gen_data<Key>(num_entries, g);
+    std::vector<std::pair<Key, int32_t>> data;
+    data.reserve(keys.size());
+    for (std::size_t i = 0; i != keys.size(); ++i)
+        data.emplace_back(keys[i], int32_t(i));
+
+    /* Look up keys uniformly from the key range; about half of them miss. */
+    std::uniform_int_distribution<Key> dist_key(keys.front(), keys.back());
+    std::vector<Key> lookup_keys;
+    lookup_keys.reserve(num_point_lookups);
+    for (std::size_t i = 0; i != num_point_lookups; ++i)
+        lookup_keys.push_back(dist_key(g));
+
+    benchmark_indexes<Key>(name, data, lookup_keys);
+}
+
+template<typename Generator>
+void benchmark_strings(const char *name, const std::vector<char32> &values, Generator g)
+{
+    std::vector<std::pair<char32, int32_t>> data;
+    data.reserve(values.size());
+    for (std::size_t i = 0; i != values.size(); ++i)
+        data.emplace_back(values[i], int32_t(i));
+    std::stable_sort(data.begin(), data.end(), [](auto &l, auto &r) { return l.first < r.first; });
+
+    /* Look up existing keys, and keys that miss by their last character. */
+    std::uniform_int_distribution<std::size_t> dist_index(0, values.size() - 1);
+    std::vector<char32> lookup_keys;
+    lookup_keys.reserve(num_point_lookups);
+    for (std::size_t i = 0; i != num_point_lookups; ++i) {
+        char32 key = values[dist_index(g)];
+        const std::size_t length = std::find(key.begin(), key.end(), '\0') - key.begin();
+        if (i % 2 and length) key[length - 1] ^= 1;
+        lookup_keys.push_back(key);
+    }
+
+    benchmark_indexes<char32>(name, data, lookup_keys);
+}
+
+
+int main(int argc, char **argv)
+{
+    const char *filename = argc > 1 ? argv[1] : "resource/arch-packages.csv";
+
+    /* Read the string columns first, to fail before running any benchmark. */
+    std::vector<char32> pkg_names, licenses, packagers;
+    if (not read_column(filename, 2, pkg_names) or not read_column(filename, 5, licenses) or
+        not read_column(filename, 7, packagers)) {
+        std::cerr << "Cannot read CSV file '" << filename << "'" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Output:
+     *     art,bulkload_<data>_<index>,<ms>
+     *     art,find_<data>_<index>,<ns per lookup>,<checksum> */
+    benchmark_integers<int32_t>("int32_t", std::mt19937(0));
+    benchmark_integers<int64_t>("int64_t", std::mt19937(0));
+    benchmark_strings("pkg_name", pkg_names, std::mt19937(0));
+    benchmark_strings("licenses", licenses, std::mt19937(0));
+    benchmark_strings("packager", packagers, std::mt19937(0));
+}
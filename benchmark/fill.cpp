@@ -0,0 +1,111 @@
+#include "BTree.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+
+#ifndef NDEBUG
+constexpr std::size_t num_entries = 1e6;
+constexpr std::size_t num_inserts = 1e5;
+constexpr std::size_t num_point_lookups = 1e4;
+#else
+constexpr std::size_t num_entries = 1e7;
+constexpr std::size_t num_inserts = 1e6;
+constexpr std::size_t num_point_lookups = 1e6;
+#endif
+
+
+/** Bulkloads \p data with the given \p fill factor for leaves and inner nodes, looks up \p lookup_keys, and then
+ * inserts \p insert_keys, to weigh the read latency of lower fill against the insert throughput it buys. */
+template<typename Key, typename Value, std::size_t NODE_SIZE>
+void benchmark(const char *name, double fill, const std::vector<std::pair<Key, Value>> &data,
+               const std::vector<Key> &lookup_keys, const std::vector<Key> &insert_keys)
+{
+    using tree_type = BTree<Key, Value, NODE_SIZE>;
+    using namespace std::chrono;
+
+    auto tree = tree_type::Bulkload(data.cbegin(), data.cend(), fill, fill);
+    const auto stats_before = tree.stats();
+    std::cout << "fill,memory_" << name << ','
+              << std::round(100 * stats_before.bytes_per_key) / 100 << ','
+              << tree.height()
+              << '\n';
+
+    /*----- Benchmark `find()` after bulkloading. -----*/
+    uint64_t checksum = 0;
+    const auto t_lookup_begin = steady_clock::now();
+    for (auto k : lookup_keys) {
+        const auto it = tree.find(k);
+        checksum = (checksum << 3UL) ^ ((it == tree.end()) ? 1UL : (*it).second());
+    }
+    const auto t_lookup_end = steady_clock::now();
+    const auto ns_lookup = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+    std::cout << "fill,find_" << name << ','
+              << std::round(ns_lookup / double(lookup_keys.size())) << ','
+              << std::hex << checksum << std::dec
+              << '\n';
+
+    /*----- Benchmark `insert()`. -----*/
+    const auto t_insert_begin = steady_clock::now();
+    for (std::size_t i = 0; i != insert_keys.size(); ++i)
+        tree.insert(insert_keys[i], Value(i));
+    const auto t_insert_end = steady_clock::now();
+    const auto ns_insert = duration_cast<nanoseconds>(t_insert_end - t_insert_begin).count();
+    const auto stats_after = tree.stats();
+    std::cout << "fill,insert_" << name << ','
+              << std::round(ns_insert / double(insert_keys.size())) << ','
+              << stats_after.num_leaves - stats_before.num_leaves // the number of leaf splits
+              << '\n';
+}
+
+template<typename Key, typename Value, typename Generator>
+void benchmark_all_configurations(const char *name, Generator g)
+{
+    std::ostringstream oss;
+
+    /*----- Bulkload even keys, look up bulkloaded keys, and insert odd keys. -----*/
+    std::vector<std::pair<Key, Value>> data;
+    data.reserve(num_entries);
+    for (std::size_t i = 0; i != num_entries; ++i)
+        data.emplace_back(Key(2 * i), Value(i));
+
+    std::uniform_int_distribution<std::size_t> dist_index(0, num_entries - 1);
+    std::vector<Key> lookup_keys;
+    lookup_keys.reserve(num_point_lookups);
+    for (std::size_t i = 0; i != num_point_lookups; ++i)
+        lookup_keys.push_back(Key(2 * dist_index(g)));
+    std::vector<Key> insert_keys;
+    insert_keys.reserve(num_inserts);
+    for (std::size_t i = 0; i != num_inserts; ++i)
+        insert_keys.push_back(Key(2 * dist_index(g) + 1));
+
+#define BENCHMARK(NODE_SIZE, FILL) { \
+    oss.str(""); \
+    oss << name << '_' << NODE_SIZE << '_' << unsigned(100 * FILL); \
+    benchmark<Key, Value, NODE_SIZE>(oss.str().c_str(), FILL, data, lookup_keys, insert_keys); \
+}
+    for (double fill : { 1., .9, .8, .7, .5 }) {
+        BENCHMARK(512, fill);
+        BENCHMARK(4096, fill);
+    }
+#undef BENCHMARK
+}
+
+
+int main()
+{
+    /* Output:
+     *     fill,memory_<config>,<bytes per key>,<height>
+     *     fill,find_<config>,<ns per lookup>,<checksum>
+     *     fill,insert_<config>,<ns per insert>,<#leaf splits>
+     * where <config> is <key>__<value>_<node size>_<fill factor in percent>. */
+#define BENCHMARK(KEY, VALUE) \
+    benchmark_all_configurations<KEY, VALUE>(#KEY "__" #VALUE, std::mt19937(0))
+    BENCHMARK(int32_t, int32_t);
+    BENCHMARK(int64_t, int64_t);
+#undef BENCHMARK
+}
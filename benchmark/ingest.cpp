@@ -0,0 +1,118 @@
+#include "BufferedBTree.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+
+#ifndef NDEBUG
+constexpr std::size_t num_inserts = 1e5;
+constexpr std::size_t num_point_lookups = 1e4;
+#else
+constexpr std::size_t num_inserts = 1e7;
+constexpr std::size_t num_point_lookups = 1e6;
+#endif
+
+
+/** Inserts \p keys in the given, random order into a `BufferedBTree` and then looks up \p lookup_keys, once with
+ * messages still buffered and once after flushing all buffers.  A buffer size of zero yields a plain B+-tree that
+ * descends to the leaf on every insert. */
+template<typename Key, typename Value, std::size_t NODE_SIZE, std::size_t BUFFER_SIZE>
+void benchmark(const char *name, const std::vector<Key> &keys, const std::vector<Key> &lookup_keys)
+{
+    using tree_type = BufferedBTree<Key, Value, NODE_SIZE, BUFFER_SIZE>;
+    using namespace std::chrono;
+
+    tree_type tree;
+
+    /*----- Benchmark `insert()`. -----*/
+    const auto t_insert_begin = steady_clock::now();
+    for (std::size_t i = 0; i != keys.size(); ++i)
+        tree.insert(keys[i], Value(i));
+    const auto t_insert_end = steady_clock::now();
+
+    const auto ns_insert = duration_cast<nanoseconds>(t_insert_end - t_insert_begin).count();
+    std::cout << "ingest,insert_" << name << ','
+              << std::round(ns_insert / double(keys.size())) << ','
+              << tree.height() << ',' << tree.num_flushes()
+              << '\n';
+
+    /*----- Benchmark `find()`, with buffered messages and after flushing. -----*/
+    auto lookup = [&](const char *suffix) {
+        uint64_t checksum = 0;
+        const auto t_lookup_begin = steady_clock::now();
+        for (auto k : lookup_keys) {
+            const auto value = tree.find(k);
+            checksum = (checksum << 3UL) ^ (value ? uint64_t(*value) : 1UL);
+        }
+        const auto t_lookup_end = steady_clock::now();
+
+        const auto ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+        std::cout << "ingest,find_" << name << suffix << ','
+                  << std::round(ns / double(lookup_keys.size())) << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+    };
+    lookup("_buffered");
+
+    const auto t_flush_begin = steady_clock::now();
+    tree.flush_all();
+    const auto t_flush_end = steady_clock::now();
+    std::cout << "ingest,flush_" << name << ','
+              << duration_cast<milliseconds>(t_flush_end - t_flush_begin).count()
+              << '\n';
+    lookup("_flushed");
+}
+
+template<typename Key, typename Value, typename Generator>
+void benchmark_all_configurations(const char *name, Generator g)
+{
+    std::ostringstream oss;
+
+    /*----- Generate random keys to insert and to look up; about half of the lookups miss. -----*/
+    std::uniform_int_distribution<Key> dist_key(0, std::numeric_limits<Key>::max());
+    std::vector<Key> keys;
+    keys.reserve(num_inserts);
+    for (std::size_t i = 0; i != num_inserts; ++i)
+        keys.push_back(dist_key(g));
+
+    std::vector<Key> lookup_keys;
+    lookup_keys.reserve(num_point_lookups);
+    std::uniform_int_distribution<std::size_t> dist_index(0, keys.size() - 1);
+    for (std::size_t i = 0; i != num_point_lookups; ++i)
+        lookup_keys.push_back(i % 2 ? keys[dist_index(g)] : dist_key(g));
+
+#define BENCHMARK(NODE_SIZE, BUFFER_SIZE) { \
+    oss.str(""); \
+    oss << name << '_' << NODE_SIZE << '_' << BUFFER_SIZE; \
+    benchmark<Key, Value, NODE_SIZE, BUFFER_SIZE>(oss.str().c_str(), keys, lookup_keys); \
+}
+    BENCHMARK(512, 0);
+    BENCHMARK(512, 256);
+    BENCHMARK(4096, 0);
+    BENCHMARK(4096, 1024);
+    BENCHMARK(4096, 2048);
+    BENCHMARK(4096, 3072);
+    BENCHMARK(16384, 0);
+    BENCHMARK(16384, 8192);
+#undef BENCHMARK
+}
+
+
+int main()
+{
+    /* Output:
+     *     ingest,insert_<config>,<ns per insert>,<height>,<#flushes>
+     *     ingest,find_<config>_{buffered,flushed},<ns per lookup>,<checksum>
+     *     ingest,flush_<config>,<ms>
+     * where <config> is <key>__<value>_<node size>_<buffer size>; a buffer size of 0 is the plain B+-tree. */
+#define BENCHMARK(KEY, VALUE) \
+    benchmark_all_configurations<KEY, VALUE>(#KEY "__" #VALUE, std::mt19937(0))
+    BENCHMARK(int32_t, int32_t);
+    BENCHMARK(int64_t, int64_t);
+#undef BENCHMARK
+}
@@ -1,21 +1,33 @@
+#include "bitpacking.hpp"
 #include "data_layouts.hpp"
+#include "dictionary.hpp"
+#include "zone_map.hpp"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <mutable/util/macro.hpp>
+#include <random>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 
 #ifndef NDEBUG
 constexpr int32_t NUM_TUPLES_RW = 5e5;
+constexpr int32_t NUM_TUPLES_RW_LARGE = 5e6;
 #else
 constexpr int32_t NUM_TUPLES_RW = 5e6;
+constexpr int32_t NUM_TUPLES_RW_LARGE = 1e8; ///< scans of tables much larger than the TLB reach
 #endif
 
 
-template<typename Layout>
-void benchmark_store(const char *name)
+template<typename Layout, int32_t NumTuplesRW = NUM_TUPLES_RW, typename... Args>
+void benchmark_store(const char *name, Args&&... args)
 {
     /* Clear the catalog before starting a new benchmark. */
     m::Catalog::Clear();
@@ -30,7 +42,7 @@ void benchmark_store(const char *name)
     C.default_backend("WasmV8");
 
     /* Register our store and set as default store. */
-    C.register_data_layout(name, std::make_unique<Layout>(), name);
+    C.register_data_layout(name, std::make_unique<Layout>(std::forward<Args>(args)...), name);
     C.default_data_layout(name);
 
     /* Create database 'dbsys' and select it. */
@@ -71,14 +83,14 @@ void benchmark_store(const char *name)
         table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.store(C.create_store(table));
-        table.layout(C.data_layout().make(table.schema()));
+        table.layout(C.data_layout().make(table.schema(), NumTuplesRW)); // bulkloaded, hence the size is known
 
         /* Get a handle on the backing store, create a writer, and an I/O tuple. */
         auto &store = table.store();
         m::StoreWriter W(store);
         m::Tuple tup(table.schema());
 
-        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        for (int32_t i = 0; i != NumTuplesRW; ++i) {
             /* Set tuple data (i, 2*i). */
             tup.set(0, i);
             tup.set(1, i<<1);
@@ -118,14 +130,14 @@ void benchmark_store(const char *name)
         table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.store(C.create_store(table));
-        table.layout(C.data_layout().make(table.schema()));
+        table.layout(C.data_layout().make(table.schema(), NumTuplesRW)); // bulkloaded, hence the size is known
 
         /* Get a handle on the backing store, create a writer, and an I/O tuple. */
         auto &store = table.store();
         m::StoreWriter W(store);
         m::Tuple tup(W.schema());
 
-        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        for (int32_t i = 0; i != NumTuplesRW; ++i) {
             /* Set tuple data (i, 2*i). */
             tup.set(0, i);
             tup.set(1, i<<1);
@@ -153,12 +165,255 @@ void benchmark_store(const char *name)
                   << std::hex << checksum << std::dec
                   << '\n';
     }
+
+    /* Evaluate read performance - scan of the narrow attributes of a table with a wide character sequence. */
+    {
+        /* Create a table like `packages`, whose `description` is rarely accessed.  Its size does not scale with
+         * `NumTuplesRW`, as the wide attribute would not fit into memory. */
+        auto &table = DB.add_table(C.pool("narrow_scan"));
+        table.push_back(C.pool("id"),          m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("description"), m::Type::Get_Char(m::Type::TY_Vector, 80));
+        table.push_back(C.pool("size"),        m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        table.store(C.create_store(table));
+        table.layout(C.data_layout().make(table.schema(), NUM_TUPLES_RW)); // bulkloaded, hence the size is known
+
+        /* Get a handle on the backing store, create a writer, and an I/O tuple. */
+        auto &store = table.store();
+        m::StoreWriter W(store);
+        m::Tuple tup(W.schema());
+
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+            /* Set tuple data (i, NULL, 1024*i). */
+            tup.set(0, i);
+            tup.set(2, int64_t(i) << 10);
+            W.append(tup);
+        }
+
+        auto stmt = m::statement_from_string(diag, "SELECT id, size FROM narrow_scan;");
+        auto query = m::as<m::ast::SelectStmt>(std::move(stmt));
+
+        uint64_t checksum = 0;
+        auto op = std::make_unique<m::CallbackOperator>([&checksum](const m::Schema&, const m::Tuple &T) {
+                checksum += T.get(0).as_i() * 3;
+                checksum += T.get(1).as_i() * 5;
+        });
+
+        using namespace std::chrono;
+        auto t_read_begin = steady_clock::now();
+        m::execute_query(diag, *query, std::move(op));
+        auto t_read_end = steady_clock::now();
+
+        std::cout << "milestone1,narrow_scan," << name << ','
+                  << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+    }
+}
+
+/** Compares a plain column of \p column values of type `CHAR(N)` with \p num_distinct distinct values to its dictionary
+ * encoding with codes of type \p Code: the size of the column and the time of an equality predicate and a grouping. */
+template<std::size_t N, typename Code>
+void benchmark_dictionary(const char *column, std::size_t num_distinct)
+{
+    using value_type = typename dictionary_column<N, Code>::value_type;
+    using namespace std::chrono;
+
+    /* Build the plain and the encoded column row by row, as when loading a CSV file. */
+    std::mt19937 g(42);
+    std::uniform_int_distribution<std::size_t> dist(0, num_distinct - 1);
+    std::vector<value_type> plain;
+    plain.reserve(NUM_TUPLES_RW);
+    dictionary_column<N, Code> encoded;
+    for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        value_type value{};
+        std::snprintf(value.data(), N, "%s_%zu", column, dist(g));
+        plain.push_back(value);
+        [[maybe_unused]] const bool appended = encoded.append(value);
+        M_insist(appended, "too many distinct values for the codes");
+    }
+    std::cout << "milestone1,dictionary_size," << column << ','
+              << plain.size() * N << ','
+              << encoded.size_in_bytes()
+              << '\n';
+
+    /* Evaluate an equality predicate. */
+    const value_type needle = plain.front();
+    auto t_plain_begin = steady_clock::now();
+    const std::size_t count_plain = std::count(plain.begin(), plain.end(), needle);
+    auto t_plain_end = steady_clock::now();
+    const std::size_t count_encoded = encoded.count_equal(needle);
+    auto t_encoded_end = steady_clock::now();
+    std::cout << "milestone1,dictionary_eq," << column << ','
+              << duration<double, std::milli>(t_plain_end - t_plain_begin).count() << ','
+              << duration<double, std::milli>(t_encoded_end - t_plain_end).count() << ','
+              << count_plain << ',' << count_encoded
+              << '\n';
+
+    /* Group by the column and count the rows per group. */
+    t_plain_begin = steady_clock::now();
+    std::unordered_map<std::string, std::size_t> groups_plain;
+    for (const value_type &value : plain)
+        ++groups_plain[std::string(value.data(), N)];
+    t_plain_end = steady_clock::now();
+    const auto groups_encoded = encoded.count_by_code();
+    t_encoded_end = steady_clock::now();
+    std::cout << "milestone1,dictionary_groupby," << column << ','
+              << duration<double, std::milli>(t_plain_end - t_plain_begin).count() << ','
+              << duration<double, std::milli>(t_encoded_end - t_plain_end).count() << ','
+              << groups_plain.size() << ',' << groups_encoded.size()
+              << '\n';
+}
+
+/** Scans the table of the read benchmarks of `benchmark_store()` in a `bitpacked_pax_table` of 4 KiB blocks, with
+ * frame-of-reference encoded and bit-packed minipages iff \p compress, and reports the bytes of the table and the times
+ * of the full and the partial scan. */
+void benchmark_bitpacked(const char *name, bool compress)
+{
+    using namespace std::chrono;
+
+    bitpacked_pax_table table(4, 4096, compress);
+    for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        const int32_t row[] = { i, i<<1, i<<1, i<<1 };
+        table.append(row);
+    }
+    table.flush();
+    std::cout << "milestone1,bitpacked_size," << name << ','
+              << table.size_in_bytes() << ','
+              << table.blocks().size()
+              << '\n';
+
+    /* Full table scan. */
+    {
+        uint64_t checksum = 0;
+        auto t_read_begin = steady_clock::now();
+        table.scan({ 0, 1, 2, 3 }, [&checksum](const int32_t *const *values, std::size_t n) {
+            for (std::size_t i = 0; i != n; ++i) {
+                checksum += values[0][i] * 3;
+                checksum += values[1][i] * 5;
+                checksum += values[2][i] * 7;
+                checksum += values[3][i] * 11;
+            }
+        });
+        auto t_read_end = steady_clock::now();
+        std::cout << "milestone1,full_scan," << name << ','
+                  << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+    }
+
+    /* Partial table scan. */
+    {
+        uint64_t checksum = 0;
+        auto t_read_begin = steady_clock::now();
+        table.scan({ 0, 3 }, [&checksum](const int32_t *const *values, std::size_t n) {
+            for (std::size_t i = 0; i != n; ++i) {
+                checksum += values[0][i] * 3;
+                checksum += values[1][i] * 5;
+            }
+        });
+        auto t_read_end = steady_clock::now();
+        std::cout << "milestone1,partial_scan," << name << ','
+                  << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+    }
+}
+
+/** Sweeps the selectivity of the predicate `size > threshold`, as in `resource/query.sql`, on a column of package sizes
+ * and compares a full scan to a scan that consults a zone map of blocks of 1024 rows.  If \p clustered, the sizes
+ * grow with the row, otherwise they are random.  Reports the fraction of skipped blocks and both times. */
+void benchmark_zone_map(const char *column, bool clustered)
+{
+    using namespace std::chrono;
+    constexpr std::size_t NUM_TUPLES_PER_BLOCK = 1024;
+
+    std::mt19937_64 g(42);
+    std::uniform_int_distribution<int64_t> noise(0, 1 << 20);
+    std::uniform_int_distribution<int64_t> random_size(0, int64_t(NUM_TUPLES_RW) << 12);
+    std::vector<int64_t> sizes;
+    sizes.reserve(NUM_TUPLES_RW);
+    zone_map<int64_t> zm(NUM_TUPLES_PER_BLOCK);
+    for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        sizes.push_back(clustered ? (int64_t(i) << 12) + noise(g) : random_size(g));
+        zm.append(sizes.back());
+    }
+    std::vector<int64_t> sorted(sizes);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (double selectivity : { 0.0001, 0.001, 0.01, 0.1, 0.5, 1.0 }) {
+        const std::size_t num_qualifying = selectivity * sizes.size();
+        const int64_t threshold = num_qualifying == sizes.size() ? sorted.front() - 1
+                                                                 : sorted[sizes.size() - num_qualifying - 1];
+
+        std::size_t count_full = 0;
+        auto t_full_begin = steady_clock::now();
+        for (int64_t size : sizes)
+            count_full += size > threshold;
+        auto t_full_end = steady_clock::now();
+
+        std::size_t count_zm = 0;
+        const std::size_t num_skipped = zm.scan([threshold](auto &z) { return z.max > threshold; },
+                                                [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i != last; ++i)
+                count_zm += sizes[i] > threshold;
+        });
+        auto t_zm_end = steady_clock::now();
+
+        std::cout << "milestone1,zone_map," << column << ',' << selectivity << ','
+                  << double(num_skipped) / zm.num_blocks() << ','
+                  << duration<double, std::milli>(t_full_end - t_full_begin).count() << ','
+                  << duration<double, std::milli>(t_zm_end - t_full_end).count() << ','
+                  << count_full << ',' << count_zm
+                  << '\n';
+    }
 }
 
 int main()
 {
     benchmark_store<MyNaiveRowLayoutFactory>("row_naive");
     benchmark_store<MyOptimizedRowLayoutFactory>("row_optimized");
+    benchmark_store<MyOutOfLineRowLayoutFactory>("row_out_of_line");
     benchmark_store<MyPAX4kLayoutFactory>("pax");
+    benchmark_store<MyPAXLayoutFactory>("pax_1k", 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax_16k", 16 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax_64k", 64 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax_1M", 1024 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax_auto", MyPAXLayoutFactory::AUTO);
+    /* The size of the aligned layouts shows the space cost of the padding, the scans the speedup. */
+    benchmark_store<MyPAXLayoutFactory>("pax_aligned", 4096, true);
+    benchmark_store<MyPAXLayoutFactory>("pax_64k_aligned", 64 * 1024, true);
+    /* Compare the nested layout in huge pages to plain PAX on a large table. */
+    benchmark_store<MyHugePagePAXLayoutFactory>("pax_huge_page");
+    benchmark_store<MyPAX4kLayoutFactory, NUM_TUPLES_RW_LARGE>("pax_large");
+    benchmark_store<MyHugePagePAXLayoutFactory, NUM_TUPLES_RW_LARGE>("pax_huge_page_large");
+    benchmark_store<MyColumnarLayoutFactory>("columnar");
+    /* Group `key` and `value2`, the attributes accessed by `partial_scan`. */
+    benchmark_store<MyColumnGroupLayoutFactory>("column_groups", std::vector<MyColumnGroupLayoutFactory::group_type>{
+        { 0, 3 },
+    });
     m::Catalog::Destroy();
+
+    /* Output:
+     *     milestone1,dictionary_size,<column>,<plain bytes>,<encoded bytes>
+     *     milestone1,dictionary_eq,<column>,<plain ms>,<encoded ms>,<plain count>,<encoded count>
+     *     milestone1,dictionary_groupby,<column>,<plain ms>,<encoded ms>,<plain #groups>,<encoded #groups>
+     * for low-cardinality columns like those of `arch-packages.csv`. */
+    benchmark_dictionary<10, uint8_t>("repo", 6);
+    benchmark_dictionary<32, uint8_t>("licenses", 100);
+    benchmark_dictionary<32, uint16_t>("packager", 500);
+
+    /* Output:
+     *     milestone1,bitpacked_size,<name>,<bytes>,<#blocks>
+     *     milestone1,full_scan,<name>,<ms>,<checksum>
+     *     milestone1,partial_scan,<name>,<ms>,<checksum>
+     * for plain and for frame-of-reference encoded, bit-packed PAX minipages. */
+    benchmark_bitpacked("pax_plain", false);
+    benchmark_bitpacked("pax_for", true);
+
+    /* Output:
+     *     milestone1,zone_map,<column>,<selectivity>,<skipped fraction>,<full ms>,<zone map ms>,<full count>,
+     *         <zone map count>
+     * for a clustered and a random column. */
+    benchmark_zone_map("size_clustered", true);
+    benchmark_zone_map("size_random", false);
 }
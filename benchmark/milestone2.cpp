@@ -1,11 +1,18 @@
 #include "BTree.hpp"
+#include "HashIndex.hpp"
+#include "LookupCache.hpp"
+#include "VEBTree.hpp"
+#include "perf_counters.hpp"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 
@@ -103,7 +110,67 @@ std::vector<Key> draw_lookup_keys(const std::vector<Key> &keys, const std::vecto
     return lookup_keys;
 }
 
-template<typename Key, typename Value, std::size_t NODE_SIZE, typename Generator>
+/** Draws ranks `1` to `n` following a Zipf distribution with exponent `s > 0`, i.e. rank `k` with probability
+ * proportional to `1 / k^s`.  Uses rejection-inversion sampling (Hörmann and Derflinger, "Rejection-inversion to
+ * generate variates from monotone discrete distributions", 1996), which requires constant time and space. */
+class zipf_distribution
+{
+    double s_, n_;
+    double h_integral_x1_, h_integral_n_, threshold_;
+
+    public:
+    zipf_distribution(std::size_t n, double s) : s_(s), n_(n) {
+        h_integral_x1_ = h_integral(1.5) - 1.;
+        h_integral_n_ = h_integral(n_ + .5);
+        threshold_ = 2. - h_integral_inverse(h_integral(2.5) - h(2.));
+    }
+
+    template<typename Generator>
+    std::size_t operator()(Generator &g) {
+        std::uniform_real_distribution<double> dist(0., 1.);
+        for (;;) {
+            const double u = h_integral_n_ + dist(g) * (h_integral_x1_ - h_integral_n_);
+            const double x = h_integral_inverse(u);
+            const double k = std::clamp(std::floor(x + .5), 1., n_);
+            if (k - x <= threshold_ or u >= h_integral(k + .5) - h(k))
+                return k;
+        }
+    }
+
+    private:
+    double h(double x) const { return std::exp(-s_ * std::log(x)); }
+    double h_integral(double x) const {
+        const double log_x = std::log(x);
+        return helper2((1. - s_) * log_x) * log_x;
+    }
+    double h_integral_inverse(double x) const {
+        const double t = std::max(-1., x * (1. - s_));
+        return std::exp(helper1(t) * x);
+    }
+    /** `log(1 + x) / x`, continued to 1 at 0. */
+    static double helper1(double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1. - x / 2.; }
+    /** `(exp(x) - 1) / x`, continued to 1 at 0. */
+    static double helper2(double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1. + x / 2.; }
+};
+
+/** Draws \p count lookup keys from the distinct \p keys following a Zipf distribution with exponent \p skew.  The
+ * popularity ranks are assigned to the keys at random. */
+template<typename Key, typename Generator>
+std::vector<Key> draw_zipf_lookup_keys(const std::vector<Key> &keys, double skew, std::size_t count, Generator &&g)
+{
+    std::vector<Key> distinct;
+    std::unique_copy(keys.begin(), keys.end(), std::back_inserter(distinct));
+    std::shuffle(distinct.begin(), distinct.end(), g);
+
+    zipf_distribution dist_rank(distinct.size(), skew);
+    std::vector<Key> lookup_keys;
+    lookup_keys.reserve(count);
+    for (std::size_t i = 0; i != count; ++i)
+        lookup_keys.push_back(distinct[dist_rank(g) - 1]);
+    return lookup_keys;
+}
+
+template<typename Key, typename Value, std::size_t NODE_SIZE, typename Search, typename Generator>
 void benchmark(
     const char *name,
     const std::vector<Key> &keys,
@@ -111,12 +178,119 @@ void benchmark(
     const std::vector<Key> &misses,
     Generator g
 ) {
-    using tree_type = BTree<Key, Value, NODE_SIZE>;
+    using tree_type = BTree<Key, Value, NODE_SIZE, NODE_SIZE, Search>;
+    using namespace std::chrono;
+
+    const float hit_ratios[] = { .05f, .95f, };
+    std::vector<std::vector<Key>> lookup_keys_per_ratio;
+    std::vector<perf_counters::values> hardware_per_ratio;
+
+    /* The timed tree lives in this scope only, such that it is destroyed before the counting tree is built. */
+    {
+        /*----- Bulkload data. -----*/
+        const auto t_bulkload_begin = steady_clock::now();
+        const auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        const auto t_bulkload_end = steady_clock::now();
+
+        std::cout << "milestone2,bulkload_" << name << ','
+                  << duration_cast<milliseconds>(t_bulkload_end - t_bulkload_begin).count()
+                  << '\n';
+
+        /*----- Report the structure and memory of the tree. -----*/
+        const auto stats = tree.stats();
+        std::cout << "milestone2,memory_" << name << ','
+                  << stats.total_bytes << ','
+                  << stats.padding_bytes << ','
+                  << stats.unused_bytes << ','
+                  << std::round(100 * stats.bytes_per_key) / 100
+                  << '\n';
+        for (std::size_t l = 0; l != stats.levels.size(); ++l) {
+            const auto &level = stats.levels[l];
+            std::cout << "milestone2,level_" << name << '_' << l << ','
+                      << level.num_nodes << ','
+                      << std::round(1000 * level.avg_fill) / 1000 << ','
+                      << std::round(1000 * level.min_fill) / 1000
+                      << '\n';
+        }
+
+        /*----- Benchmark `find()`. -----*/
+        perf_counters counters;
+        uint64_t checksum;
+        for (const float hit_ratio : hit_ratios) {
+            const auto &lookup_keys = lookup_keys_per_ratio.emplace_back(
+                draw_lookup_keys(keys, misses, hit_ratio, num_point_lookups, g));
+            checksum = 0;
+
+            counters.start();
+            const auto t_lookup_begin = steady_clock::now();
+            for (auto k : lookup_keys) {
+                const auto it = tree.find(k);
+                const uint64_t v = (it == tree.cend()) ? 1UL : (*it).second();
+                checksum = (checksum << 3UL) ^ v;
+
+            }
+            const auto t_lookup_end = steady_clock::now();
+            hardware_per_ratio.push_back(counters.stop());
+
+            const auto ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+            std::cout << "milestone2,find_" << name << '_' << unsigned(100 * hit_ratio) << ','
+                      << std::round(ns / double(num_point_lookups)) << ','
+                      << std::hex << checksum << std::dec
+                      << '\n';
+        }
+
+        /*----- Benchmark `parallel_scan()` over the entire key range. -----*/
+        const std::size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+        for (std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+            const auto t_scan_begin = steady_clock::now();
+            checksum = tree.parallel_scan(std::numeric_limits<Key>::lowest(), std::numeric_limits<Key>::max(),
+                                          num_threads, uint64_t(0),
+                                          [](uint64_t &acc, const Key&, const Value &v) { acc += v; },
+                                          [](uint64_t left, uint64_t right) { return left + right; });
+            const auto t_scan_end = steady_clock::now();
+
+            const auto ns = duration_cast<nanoseconds>(t_scan_end - t_scan_begin).count();
+            const double bytes = tree.size() * (sizeof(Key) + sizeof(Value));
+            std::cout << "milestone2,scan_" << name << '_' << num_threads << ','
+                      << std::round(100 * bytes / ns) / 100 << ',' // GB/s
+                      << std::hex << checksum << std::dec
+                      << '\n';
+        }
+    }
+
+    /*----- Count nodes and comparisons of `find()` in a separate, untimed run. -----*/
+    /* The counting tree is only built after the timed tree is destroyed, such that no two full trees are resident. */
+    using counting_tree_type = BTree<Key, Value, NODE_SIZE, NODE_SIZE, counting_search<Search>>;
+    using counting_type = counting_search<Search>;
+    const auto counting_tree = counting_tree_type::Bulkload(data.cbegin(), data.cend());
+    for (std::size_t i = 0; i != std::size(hit_ratios); ++i) {
+        counting_type::reset();
+        for (auto k : lookup_keys_per_ratio[i])
+            (void) counting_tree.find(k);
+        std::cout << "milestone2,perf_find_" << name << '_' << unsigned(100 * hit_ratios[i]) << ',';
+        hardware_per_ratio[i].print_per(std::cout, num_point_lookups);
+        std::cout << ',' << std::round(100. * counting_type::num_nodes / num_point_lookups) / 100
+                  << ',' << std::round(100. * counting_type::num_comparisons / num_point_lookups) / 100
+                  << '\n';
+    }
+}
+
+/** Benchmarks bulkloading and `find()` of an `Index` other than `BTree`, e.g. `HashIndex` or `VEBTree`, as
+ * `benchmark()` does for `BTree`s. */
+template<typename Index, typename Key, typename Value, typename Generator>
+void benchmark_index(
+    const char *name,
+    const std::vector<Key> &keys,
+    const std::vector<std::pair<Key, Value>> &data,
+    const std::vector<Key> &misses,
+    Generator g
+) {
+    using index_type = Index;
     using namespace std::chrono;
 
     /*----- Bulkload data. -----*/
     const auto t_bulkload_begin = steady_clock::now();
-    const auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+    const auto index = index_type::Bulkload(data.cbegin(), data.cend());
     const auto t_bulkload_end = steady_clock::now();
 
     std::cout << "milestone2,bulkload_" << name << ','
@@ -124,17 +298,15 @@ void benchmark(
               << '\n';
 
     /*----- Benchmark `find()`. -----*/
-    uint64_t checksum;
     for (const float hit_ratio : {.05f, .95f,}) {
         const auto lookup_keys = draw_lookup_keys(keys, misses, hit_ratio, num_point_lookups, g);
-        checksum = 0;
+        uint64_t checksum = 0;
 
         const auto t_lookup_begin = steady_clock::now();
         for (auto k : lookup_keys) {
-            const auto it = tree.find(k);
-            const uint64_t v = (it == tree.cend()) ? 1UL : (*it).second();
+            const auto it = index.find(k);
+            const uint64_t v = (it == index.cend()) ? 1UL : (*it).second();
             checksum = (checksum << 3UL) ^ v;
-
         }
         const auto t_lookup_end = steady_clock::now();
 
@@ -146,6 +318,98 @@ void benchmark(
     }
 }
 
+/** Benchmarks `find()` of a `BTree` with and without a `LookupCache` in front, for lookups of increasing skew. */
+template<typename Key, typename Value, std::size_t NODE_SIZE, typename Generator>
+void benchmark_skew(
+    const char *name,
+    const std::vector<Key> &keys,
+    const std::vector<std::pair<Key, Value>> &data,
+    Generator g
+) {
+    using tree_type = BTree<Key, Value, NODE_SIZE>;
+    using cache_type = LookupCache<tree_type>;
+    using namespace std::chrono;
+
+    const auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+    for (const double skew : {.5, .8, .99, 1.2, 1.5}) {
+        const auto lookup_keys = draw_zipf_lookup_keys(keys, skew, num_point_lookups, g);
+        std::ostringstream oss;
+        oss << name << "_zipf" << skew;
+
+        /*----- Without cache. -----*/
+        uint64_t checksum = 0;
+        auto t_lookup_begin = steady_clock::now();
+        for (auto k : lookup_keys) {
+            const auto it = tree.find(k);
+            checksum = (checksum << 3UL) ^ ((it == tree.cend()) ? 1UL : (*it).second());
+        }
+        auto t_lookup_end = steady_clock::now();
+        auto ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+        std::cout << "milestone2,find_" << oss.str() << ','
+                  << std::round(ns / double(num_point_lookups)) << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+
+        /*----- With cache. -----*/
+        cache_type cache(tree);
+        checksum = 0;
+        t_lookup_begin = steady_clock::now();
+        for (auto k : lookup_keys) {
+            const auto it = cache.find(k);
+            checksum = (checksum << 3UL) ^ ((it == tree.cend()) ? 1UL : (*it).second());
+        }
+        t_lookup_end = steady_clock::now();
+        ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count();
+        std::cout << "milestone2,find_" << oss.str() << "_cached,"
+                  << std::round(ns / double(num_point_lookups)) << ','
+                  << std::hex << checksum << std::dec << ','
+                  << std::round(1000. * cache.num_hits() / num_point_lookups) / 10 // hit ratio in percent
+                  << '\n';
+    }
+}
+
+/** Benchmarks bulkloading unsorted data with `BTree::BulkloadUnsorted()`, reporting the times of sorting and of
+ * building the tree separately, and compares the radix sort to a single-threaded `std::sort()`. */
+template<typename Key, typename Value, std::size_t NODE_SIZE, typename Generator>
+void benchmark_unsorted(const char *name, const std::vector<std::pair<Key, Value>> &data, Generator g)
+{
+    using tree_type = BTree<Key, Value, NODE_SIZE>;
+    using namespace std::chrono;
+
+    auto shuffled = data;
+    std::shuffle(shuffled.begin(), shuffled.end(), g);
+
+    /*----- Baseline:  sort with `std::sort()`. -----*/
+    {
+        auto unsorted = shuffled;
+        const auto t_sort_begin = steady_clock::now();
+        std::sort(unsorted.begin(), unsorted.end(), [](auto &left, auto &right) { return left.first < right.first; });
+        const auto t_sort_end = steady_clock::now();
+        std::cout << "milestone2,sort_" << name << "_std,"
+                  << duration_cast<milliseconds>(t_sort_end - t_sort_begin).count()
+                  << '\n';
+    }
+
+    /*----- Sort with the radix sort and bulkload. -----*/
+    const std::size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+    for (std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        auto unsorted = shuffled;
+        typename tree_type::bulkload_times times;
+        const auto tree = tree_type::BulkloadUnsorted(unsorted.begin(), unsorted.end(), num_threads, &times);
+        uint64_t checksum = 0;
+        for (auto p : tree)
+            checksum = (checksum << 3UL) ^ p.second();
+        std::cout << "milestone2,sort_" << name << "_radix_" << num_threads << ','
+                  << std::round(times.sort_ms) << ','
+                  << std::hex << checksum << std::dec
+                  << '\n'
+                  << "milestone2,build_" << name << "_unsorted_" << num_threads << ','
+                  << std::round(times.build_ms)
+                  << '\n';
+    }
+}
+
 template<typename Key, typename Value, typename Generator>
 void benchmark_all_node_sizes(const char *name, Generator g)
 {
@@ -167,17 +431,59 @@ void benchmark_all_node_sizes(const char *name, Generator g)
 #define BENCHMARK(NODE_SIZE) { \
     oss.str(""); \
     oss << name << '_' << NODE_SIZE; \
-    benchmark<Key, Value, NODE_SIZE>(oss.str().c_str(), keys, data, misses, g); \
+    benchmark<Key, Value, NODE_SIZE, linear_search>(oss.str().c_str(), keys, data, misses, g); \
 }
     BENCHMARK(64);
     BENCHMARK(512);
     BENCHMARK(4096);
 #undef BENCHMARK
+
+    /*----- Compare the policies to search within a node. -----*/
+#define BENCHMARK(NODE_SIZE, SEARCH) { \
+    oss.str(""); \
+    oss << name << '_' << NODE_SIZE << '_' << #SEARCH; \
+    benchmark<Key, Value, NODE_SIZE, SEARCH>(oss.str().c_str(), keys, data, misses, g); \
+}
+    BENCHMARK(64, binary_search);
+    BENCHMARK(64, simd_search);
+    BENCHMARK(64, interpolation_search);
+    BENCHMARK(512, binary_search);
+    BENCHMARK(512, simd_search);
+    BENCHMARK(512, interpolation_search);
+    BENCHMARK(4096, binary_search);
+    BENCHMARK(4096, simd_search);
+    BENCHMARK(4096, interpolation_search);
+#undef BENCHMARK
+
+    /*----- Compare with other indexes. -----*/
+#define BENCHMARK(INDEX, SUFFIX) { \
+    oss.str(""); \
+    oss << name << '_' << SUFFIX; \
+    benchmark_index<INDEX<Key, Value>>(oss.str().c_str(), keys, data, misses, g); \
+}
+    BENCHMARK(HashIndex, "hash"); // unordered
+    BENCHMARK(VEBTree, "veb"); // cache-oblivious
+#undef BENCHMARK
+
+    /*----- Bulkload unsorted data. -----*/
+    oss.str("");
+    oss << name << "_4096";
+    benchmark_unsorted<Key, Value, 4096>(oss.str().c_str(), data, g);
+
+    /*----- Skewed lookups with a hot-key cache. -----*/
+    oss.str("");
+    oss << name << "_512";
+    benchmark_skew<Key, Value, 512>(oss.str().c_str(), keys, data, g);
 }
 
 
 int main()
 {
+    /* Besides wall-clock times, every `find()` benchmark of a `BTree` reports
+     *     milestone2,perf_find_<config>,<instructions>,<L1D misses>,<LLC misses>,<dTLB misses>,<branch misses>,
+     *                                   <nodes visited>,<comparisons>
+     * all per lookup; hardware events that cannot be counted, e.g. without permission for `perf_event_open()`, are
+     * reported as n/a. */
 #define BENCHMARK(KEY, VALUE) \
     benchmark_all_node_sizes<KEY, VALUE>(#KEY "__" #VALUE, std::mt19937(0))
     BENCHMARK(int32_t, int32_t);
@@ -0,0 +1,120 @@
+#include "BTree.hpp"
+#include "ReplicatedIndex.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+#ifndef NDEBUG
+constexpr std::size_t num_entries = 1e6;
+constexpr std::size_t num_point_lookups_per_thread = 1e4;
+#else
+constexpr std::size_t num_entries = 1e7;
+constexpr std::size_t num_point_lookups_per_thread = 1e6;
+#endif
+
+
+/** Runs point lookups on one thread per CPU of the machine, each pinned to its CPU, and reports the mean latency per
+ * lookup.  Every thread looks up keys in the replica returned by `choose_replica`, which is called on the thread after
+ * pinning. */
+template<typename Replicated, typename Choose>
+void benchmark_lookups(const char *name, const Replicated &replicated, int32_t max_key, Choose choose_replica)
+{
+    using namespace std::chrono;
+    const auto &topo = numa::topology::Get();
+
+    std::atomic<uint64_t> checksum = 0;
+    std::atomic<uint64_t> total_ns = 0;
+    std::atomic<std::size_t> num_ready = 0;
+    std::atomic_bool go = false;
+    std::vector<std::thread> threads;
+    std::size_t num_threads = 0;
+    for (std::size_t node = 0; node != topo.num_nodes(); ++node) {
+        for (unsigned cpu : topo.cpus[node]) {
+            ++num_threads;
+            threads.emplace_back([&, cpu, node]() {
+                numa::pin_thread_to_cpu(cpu);
+                const auto &tree = choose_replica(replicated, node);
+
+                std::mt19937 g(cpu);
+                std::uniform_int_distribution<int32_t> dist_key(0, max_key);
+                std::vector<int32_t> lookup_keys(num_point_lookups_per_thread);
+                for (auto &k : lookup_keys) k = dist_key(g);
+
+                /* Start all threads at once, to load the memory system of all nodes concurrently. */
+                ++num_ready;
+                while (not go) std::this_thread::yield();
+
+                uint64_t local_checksum = 0;
+                const auto t_begin = steady_clock::now();
+                for (auto k : lookup_keys) {
+                    const auto it = tree.find(k);
+                    local_checksum = (local_checksum << 3UL) ^ ((it == tree.cend()) ? 1UL : (*it).second());
+                }
+                const auto t_end = steady_clock::now();
+                total_ns += duration_cast<nanoseconds>(t_end - t_begin).count();
+                checksum ^= local_checksum;
+            });
+        }
+    }
+    while (num_ready != num_threads) std::this_thread::yield();
+    go = true;
+    for (auto &t : threads)
+        t.join();
+
+    std::cout << "numa,find_" << name << ','
+              << std::round(total_ns / double(num_threads * num_point_lookups_per_thread)) << ','
+              << std::hex << checksum << std::dec
+              << '\n';
+}
+
+template<std::size_t NODE_SIZE>
+void benchmark_node_size(const char *name)
+{
+    using tree_type = BTree<int32_t, int32_t, NODE_SIZE>;
+    using namespace std::chrono;
+
+    std::vector<std::pair<int32_t, int32_t>> data;
+    data.reserve(num_entries);
+    for (std::size_t i = 0; i != num_entries; ++i)
+        data.emplace_back(2 * i, i);
+
+    const auto t_bulkload_begin = steady_clock::now();
+    const auto replicated = ReplicatedIndex<tree_type>::Bulkload(data.cbegin(), data.cend());
+    const auto t_bulkload_end = steady_clock::now();
+    std::cout << "numa,bulkload_" << name << '_' << replicated.num_replicas() << ','
+              << duration_cast<milliseconds>(t_bulkload_end - t_bulkload_begin).count()
+              << '\n';
+
+    const std::string prefix(name);
+    const int32_t max_key = 2 * num_entries;
+    /* All threads use the replica on the first node, as if the tree was not replicated. */
+    benchmark_lookups((prefix + "_single").c_str(), replicated, max_key,
+                      [](auto &r, std::size_t) -> auto & { return r.replica(0); });
+    /* Every thread uses the replica on its node. */
+    benchmark_lookups((prefix + "_local").c_str(), replicated, max_key,
+                      [](auto &r, std::size_t) -> auto & { return r.local(); });
+    /* Every thread uses the replica on another node, if there is more than one node. */
+    benchmark_lookups((prefix + "_remote").c_str(), replicated, max_key,
+                      [](auto &r, std::size_t node) -> auto & {
+                          return r.replica((node + 1) % r.num_replicas());
+                      });
+}
+
+
+int main()
+{
+    const auto &topo = numa::topology::Get();
+    std::cout << "numa,nodes," << topo.num_nodes() << '\n';
+
+    /* Output: numa,find_<config>_{single,local,remote},<mean ns per lookup>,<checksum> */
+#define BENCHMARK(NODE_SIZE) benchmark_node_size<NODE_SIZE>("int32_t__int32_t_" #NODE_SIZE)
+    BENCHMARK(512);
+    BENCHMARK(4096);
+#undef BENCHMARK
+}
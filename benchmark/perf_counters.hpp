@@ -0,0 +1,168 @@
+#pragma once
+
+#include "node_search.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+/** Counts hardware events of the calling thread with `perf_event_open(2)` around a measured region, without depending
+ * on libpfm or the `perf` tool.  Every event is opened on its own, such that events the CPU or the kernel does not
+ * support, e.g. in a VM, or that the process may not count, e.g. due to `perf_event_paranoid`, are merely reported as
+ * unavailable.  Counts are scaled up if the kernel multiplexed the counters. */
+struct perf_counters
+{
+    enum event : std::size_t
+    {
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        DTLB_MISSES,
+        BRANCH_MISSES,
+        NUM_EVENTS
+    };
+
+    static constexpr const char * NAMES[NUM_EVENTS] = {
+        "instructions", "L1D misses", "LLC misses", "dTLB misses", "branch misses",
+    };
+
+    /** The counts of one measured region; unavailable events are negative. */
+    struct values
+    {
+        std::array<double, NUM_EVENTS> counts;
+
+        bool available(event e) const { return counts[e] >= 0; }
+
+        /** Writes the counts divided by \p n, e.g. the number of lookups, as comma-separated values, and `n/a` for
+         * unavailable events. */
+        void print_per(std::ostream &out, double n) const {
+            for (std::size_t e = 0; e != NUM_EVENTS; ++e) {
+                if (e) out << ',';
+                if (counts[e] < 0)
+                    out << "n/a";
+                else
+                    out << double(std::int64_t(100 * counts[e] / n)) / 100;
+            }
+        }
+    };
+
+    private:
+    std::array<int, NUM_EVENTS> fds_;
+
+    public:
+    perf_counters() {
+        fds_.fill(-1);
+#ifdef __linux__
+        auto cache_event = [](std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+            return cache | (op << 8) | (result << 16);
+        };
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, NUM_EVENTS> configs = { {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                              PERF_COUNT_HW_CACHE_RESULT_MISS) },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+            { PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                              PERF_COUNT_HW_CACHE_RESULT_MISS) },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        } };
+        for (std::size_t e = 0; e != NUM_EVENTS; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = configs[e].first;
+            attr.config = configs[e].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[e] = syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any CPU */, -1 /* no group */, 0);
+        }
+#endif
+    }
+
+    ~perf_counters() {
+#ifdef __linux__
+        for (int fd : fds_)
+            if (fd >= 0) close(fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters & operator=(const perf_counters&) = delete;
+
+    ///> returns `true` iff event \p e can be counted
+    bool available(event e) const { return fds_[e] >= 0; }
+    ///> returns `true` iff any event can be counted
+    bool any_available() const { return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; }); }
+
+    /** Resets and starts all available counters. */
+    void start() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /** Stops all available counters and returns their counts since `start()`. */
+    values stop() {
+        values v;
+        v.counts.fill(-1);
+#ifdef __linux__
+        for (int fd : fds_)
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (std::size_t e = 0; e != NUM_EVENTS; ++e) {
+            if (fds_[e] < 0) continue;
+            std::uint64_t data[3]; // value, time enabled, time running
+            if (read(fds_[e], data, sizeof(data)) != sizeof(data) or data[2] == 0) continue;
+            v.counts[e] = double(data[0]) * double(data[1]) / double(data[2]);
+        }
+#endif
+        return v;
+    }
+};
+
+
+/** A search policy that forwards to \tparam Search and counts, per thread, the nodes searched and the key comparisons
+ * the search performed.  Comparisons are counted by \tparam Search itself, instantiated with this policy as its
+ * `Counter`, hence a SIMD comparison of a vector of keys counts as one comparison.  Meant for untimed runs, since
+ * counting adds work to every search. */
+template<typename Search>
+struct counting_search
+{
+    static inline thread_local std::size_t num_nodes = 0;
+    static inline thread_local std::size_t num_comparisons = 0;
+
+    static void reset() { num_nodes = num_comparisons = 0; }
+
+    ///> counts a key comparison of the counted search
+    static void count() { ++num_comparisons; }
+
+    template<typename Key>
+    static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key) {
+        ++num_nodes;
+        return counted_search::lower_bound(keys, n, key);
+    }
+
+    template<typename Key>
+    static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key) {
+        ++num_nodes;
+        return counted_search::upper_bound(keys, n, key);
+    }
+
+    private:
+    using counted_search = typename Search::template with_counter<counting_search>;
+};
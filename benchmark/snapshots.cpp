@@ -0,0 +1,100 @@
+#include "VersionedBTree.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#ifndef NDEBUG
+constexpr std::size_t num_entries = 1e5;
+constexpr std::size_t num_point_lookups = 1e4;
+#else
+constexpr std::size_t num_entries = 1e7;
+constexpr std::size_t num_point_lookups = 1e6;
+#endif
+
+
+/** Measures the latency of point lookups into the most recent snapshot of \p tree, while \p writer modifies the tree
+ * in a background thread, and reports the latency percentiles. */
+template<typename Tree, typename Writer, typename Generator>
+void benchmark_readers(const char *name, Tree &tree, const std::vector<typename Tree::key_type> &lookup_keys,
+                       Writer writer, Generator &g)
+{
+    using namespace std::chrono;
+
+    std::atomic_bool done = false;
+    std::size_t num_versions = 0;
+    std::thread writer_thread([&]() {
+        while (not done) {
+            writer(tree, g);
+            ++num_versions;
+        }
+    });
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(lookup_keys.size());
+    uint64_t checksum = 0;
+    for (auto key : lookup_keys) {
+        const auto t_begin = steady_clock::now();
+        const auto snapshot = tree.get_snapshot();
+        const auto value = snapshot.find(key);
+        const auto t_end = steady_clock::now();
+        checksum = (checksum << 3UL) ^ (value ? *value : 1UL);
+        latencies.push_back(duration_cast<nanoseconds>(t_end - t_begin).count());
+    }
+    done = true;
+    writer_thread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) { return latencies[std::size_t(p * (latencies.size() - 1))]; };
+    std::cout << "snapshots,find_" << name << ','
+              << percentile(.5) << ',' << percentile(.99) << ',' << percentile(.999) << ',' << latencies.back() << ','
+              << num_versions << ','
+              << std::hex << checksum << std::dec
+              << '\n';
+}
+
+template<std::size_t NODE_SIZE>
+void benchmark_node_size(const char *name)
+{
+    using tree_type = VersionedBTree<int32_t, int32_t, NODE_SIZE>;
+    std::mt19937 g(0);
+
+    std::vector<std::pair<int32_t, int32_t>> data;
+    data.reserve(num_entries);
+    for (std::size_t i = 0; i != num_entries; ++i)
+        data.emplace_back(2 * i, i); // leave gaps for inserts
+    tree_type tree(data.cbegin(), data.cend());
+
+    std::vector<int32_t> lookup_keys;
+    lookup_keys.reserve(num_point_lookups);
+    std::uniform_int_distribution<int32_t> dist_key(0, 2 * num_entries);
+    for (std::size_t i = 0; i != num_point_lookups; ++i)
+        lookup_keys.push_back(dist_key(g));
+
+    auto idle = [](tree_type&, std::mt19937&) { std::this_thread::yield(); };
+    auto insert = [&dist_key](tree_type &tree, std::mt19937 &g) { tree.insert(dist_key(g) | 1, 0); };
+    auto erase = [&dist_key](tree_type &tree, std::mt19937 &g) { tree.erase(dist_key(g) & ~1); };
+    auto rebuild = [&data](tree_type &tree, std::mt19937&) { tree.assign(data.cbegin(), data.cend()); };
+
+    std::string prefix(name);
+    benchmark_readers((prefix + "_idle").c_str(), tree, lookup_keys, idle, g);
+    benchmark_readers((prefix + "_insert").c_str(), tree, lookup_keys, insert, g);
+    benchmark_readers((prefix + "_erase").c_str(), tree, lookup_keys, erase, g);
+    benchmark_readers((prefix + "_rebuild").c_str(), tree, lookup_keys, rebuild, g);
+}
+
+
+int main()
+{
+    /* Output: snapshots,find_<config>,<p50 ns>,<p99 ns>,<p99.9 ns>,<max ns>,<#versions written>,<checksum> */
+#define BENCHMARK(NODE_SIZE) benchmark_node_size<NODE_SIZE>("int32_t__int32_t_" #NODE_SIZE)
+    BENCHMARK(512);
+    BENCHMARK(4096);
+#undef BENCHMARK
+}
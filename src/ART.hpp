@@ -0,0 +1,549 @@
+#pragma once
+
+#include "BTree.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/** Encodes keys of type \tparam Key as byte strings of fixed length `LENGTH`, such that comparing the byte strings
+ * lexicographically (as unsigned bytes) yields the same order as `operator<` on the keys. */
+template<typename Key>
+struct radix_key;
+
+/** Integers are encoded in big-endian byte order; the sign bit of signed integers is flipped to order negative before
+ * positive numbers. */
+template<std::integral Key>
+struct radix_key<Key>
+{
+    static constexpr std::size_t LENGTH = sizeof(Key);
+
+    static void encode(const Key &key, uint8_t *out) {
+        using unsigned_type = std::make_unsigned_t<Key>;
+        unsigned_type bits = unsigned_type(key);
+        if constexpr (std::is_signed_v<Key>)
+            bits ^= unsigned_type(1) << (8 * sizeof(Key) - 1);
+        for (std::size_t i = 0; i != LENGTH; ++i)
+            out[i] = uint8_t(bits >> (8 * (LENGTH - 1 - i)));
+    }
+};
+
+/** Fixed-length character strings, e.g. the values of a `CHAR(N)` attribute padded with NUL characters, are encoded
+ * character by character.  If `char` is signed, the sign bit is flipped to agree with `operator<` of `std::array`. */
+template<std::size_t N>
+struct radix_key<std::array<char, N>>
+{
+    static constexpr std::size_t LENGTH = N;
+
+    static void encode(const std::array<char, N> &key, uint8_t *out) {
+        for (std::size_t i = 0; i != LENGTH; ++i)
+            out[i] = std::is_signed_v<char> ? uint8_t(key[i]) ^ 0x80 : uint8_t(key[i]);
+    }
+};
+
+/** Require that \tparam T can be encoded as a byte string by `radix_key`. */
+template<typename T>
+concept radix_encodable = requires (const T &key, uint8_t *out) {
+    { radix_key<T>::LENGTH } -> std::convertible_to<std::size_t>;
+    radix_key<T>::encode(key, out);
+};
+
+
+/** Implements a static Adaptive Radix Tree (ART) over \tparam Key - \tparam Value pairs, with the same lookup interface
+ * as `BTree`.  The bulkloaded pairs are kept in key order in two arrays; the radix tree indexes the first pair of every
+ * distinct key.  Inner nodes span one byte of the encoded key (see `radix_key`) and adapt their representation to the
+ * number of children (`Node4`, `Node16`, `Node48`, `Node256`).  Common prefixes are compressed into the node: up to
+ * `MAX_PREFIX_LENGTH` bytes are stored and compared pessimistically, longer prefixes are skipped optimistically and
+ * verified at the leaf.  Subtrees with a single key are collapsed into a leaf (lazy expansion). */
+template<
+    typename Key,
+    std::movable Value
+>
+requires sortable<Key> and std::copyable<Key> and radix_encodable<Key>
+struct ART
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    ///> the length of encoded keys in bytes
+    static constexpr size_type KEY_LENGTH = radix_key<key_type>::LENGTH;
+    ///> the number of prefix bytes stored in a node
+    static constexpr size_type MAX_PREFIX_LENGTH = 8;
+
+    private:
+    using key_value_type = ref_pair<const key_type, mapped_type>;
+    using bytes_type = std::array<uint8_t, KEY_LENGTH>;
+
+    /** A child is either a pointer to a `Node` or, if the least significant bit is set, a leaf holding the index of the
+     * first pair with its key.  The null child is 0. */
+    using child_type = uintptr_t;
+
+    enum node_type : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+    struct Node
+    {
+        node_type type;
+        uint16_t num_children;
+        uint32_t prefix_length; ///< the number of bytes of the compressed prefix
+        std::array<uint8_t, MAX_PREFIX_LENGTH> prefix; ///< the first `MAX_PREFIX_LENGTH` bytes of the prefix
+
+        Node(node_type type) : type(type), num_children(0), prefix_length(0) { }
+    };
+
+    /** A node with up to \tparam Capacity children, stored in the order of their key bytes. */
+    template<std::size_t Capacity, node_type Type>
+    struct SortedNode : Node
+    {
+        std::array<uint8_t, Capacity> keys;
+        std::array<child_type, Capacity> children;
+
+        SortedNode() : Node(Type) { }
+    };
+    using Node4 = SortedNode<4, NODE4>;
+    using Node16 = SortedNode<16, NODE16>;
+
+    struct Node48 : Node
+    {
+        std::array<uint8_t, 256> child_index; ///< one plus the index of the child for a key byte, 0 if there is none
+        std::array<child_type, 48> children;
+
+        Node48() : Node(NODE48) { child_index.fill(0); }
+    };
+
+    struct Node256 : Node
+    {
+        std::array<child_type, 256> children;
+
+        Node256() : Node(NODE256) { children.fill(0); }
+    };
+
+    static bool is_leaf(child_type child) { return child & 1; }
+    static size_type leaf_index(child_type child) { return child >> 1; }
+    static child_type make_leaf(size_type index) { return (index << 1) | 1; }
+    static const Node * as_node(child_type child) { return reinterpret_cast<const Node*>(child); }
+
+    template<bool IsConst>
+    struct the_iterator
+    {
+        friend struct ART;
+
+        static constexpr bool is_const = IsConst;
+        using value_type = std::conditional_t<is_const, const mapped_type, mapped_type>;
+
+        private:
+        using tree_type = std::conditional_t<is_const, const ART, ART>;
+
+        tree_type *tree_;
+        size_type idx_;
+
+        public:
+        template<bool C = is_const> requires C
+        the_iterator(the_iterator<false> other) : tree_(other.tree_), idx_(other.idx_) { }
+        the_iterator(tree_type *tree, size_type idx) : tree_(tree), idx_(idx) { }
+
+        bool operator==(the_iterator other) const { return tree_ == other.tree_ and idx_ == other.idx_; }
+        bool operator!=(the_iterator other) const { return not operator==(other); }
+
+        the_iterator & operator++() { ++idx_; return *this; }
+
+        the_iterator operator++(int) {
+            the_iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        ref_pair<const key_type, value_type> operator*() const {
+            return ref_pair<const key_type, value_type>(tree_->keys_[idx_], tree_->values_[idx_]);
+        }
+    };
+
+    template<bool IsConst>
+    struct the_range
+    {
+        static constexpr bool is_const = IsConst;
+        using iter_t = the_iterator<is_const>;
+        private:
+        iter_t begin_, end_;
+
+        public:
+        the_range(iter_t begin, iter_t end) : begin_(begin), end_(end) { }
+
+        bool empty() const { return begin() == end(); }
+
+        iter_t begin() const { return begin_; }
+        iter_t end() const { return end_; }
+    };
+
+    public:
+    using iterator = the_iterator<false>;
+    using const_iterator = the_iterator<true>;
+
+    using range = the_range<false>;
+    using const_range = the_range<true>;
+
+    private:
+    std::vector<key_type> keys_;
+    std::vector<mapped_type> values_;
+    child_type root_ = 0;
+    size_type num_nodes_ = 0;
+
+    public:
+    /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive), which must be sorted by key, into
+     * a fresh `ART` and returns it. */
+    template<typename It>
+    static ART Bulkload(It begin, It end)
+    requires requires (It it) {
+        key_type(std::move(it->first));
+        mapped_type(std::move(it->second));
+    }
+    {
+        ART art;
+        for (It it = begin; it != end; ++it) {
+            art.keys_.emplace_back(std::move(it->first));
+            art.values_.emplace_back(std::move(it->second));
+        }
+
+        /* Encode the first key of every run of equal keys. */
+        std::vector<size_type> firsts;
+        std::vector<bytes_type> encoded;
+        for (size_type i = 0; i != art.keys_.size(); ++i) {
+            if (i != 0 and art.keys_[i - 1] == art.keys_[i]) continue;
+            firsts.push_back(i);
+            radix_key<key_type>::encode(art.keys_[i], encoded.emplace_back().data());
+        }
+
+        if (not firsts.empty())
+            art.root_ = art.build_(firsts, encoded, 0, firsts.size(), 0);
+        return art;
+    }
+
+    private:
+    ART() = default;
+
+    public:
+    ART(ART &&other)
+        : keys_(std::move(other.keys_))
+        , values_(std::move(other.values_))
+        , root_(std::exchange(other.root_, 0))
+        , num_nodes_(std::exchange(other.num_nodes_, 0))
+    { }
+
+    ART & operator=(ART &&other) {
+        if (this != &other) {
+            delete_(root_);
+            keys_ = std::move(other.keys_);
+            values_ = std::move(other.values_);
+            root_ = std::exchange(other.root_, 0);
+            num_nodes_ = std::exchange(other.num_nodes_, 0);
+        }
+        return *this;
+    }
+
+    ART(const ART&) = delete;
+    ART & operator=(const ART&) = delete;
+
+    ~ART() { delete_(root_); }
+
+    ///> returns the size of the tree, i.e. the number of key-value pairs
+    size_type size() const { return keys_.size(); }
+    ///> returns the number of inner nodes of the tree
+    size_type num_nodes() const { return num_nodes_; }
+
+    /** Returns an `iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    iterator begin() { return iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    iterator end() { return iterator(this, size()); }
+    /** Returns an `const_iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    const_iterator begin() const { return const_iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator end() const { return const_iterator(this, size()); }
+    /** Returns an `const_iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    const_iterator cbegin() const { return begin(); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator cend() const { return end(); }
+
+    /** Returns a `const_iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    const_iterator find(const key_type &key) const { return const_iterator(this, find_(key)); }
+    /** Returns an `iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    iterator find(const key_type &key) { return iterator(this, find_(key)); }
+
+    /** Returns a `const_range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi`
+     * excluding. */
+    const_range find_range(const key_type &lo, const key_type &hi) const {
+        auto [begin, end] = find_range_(lo, hi);
+        return const_range(const_iterator(this, begin), const_iterator(this, end));
+    }
+    /** Returns a `range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi` excluding.
+     * */
+    range find_range(const key_type &lo, const key_type &hi) {
+        auto [begin, end] = find_range_(lo, hi);
+        return range(iterator(this, begin), iterator(this, end));
+    }
+
+    /** Returns a `const_range` of all elements with key equals to \p key. */
+    const_range equal_range(const key_type &key) const {
+        auto [begin, end] = equal_range_(key);
+        return const_range(const_iterator(this, begin), const_iterator(this, end));
+    }
+    /** Returns a `range` of all elements with key equals to \p key. */
+    range equal_range(const key_type &key) {
+        auto [begin, end] = equal_range_(key);
+        return range(iterator(this, begin), iterator(this, end));
+    }
+
+    private:
+    /** Builds the subtree for the distinct keys `firsts[begin]` to `firsts[end - 1]`, which share their first \p depth
+     * bytes, and returns it. */
+    child_type build_(const std::vector<size_type> &firsts, const std::vector<bytes_type> &encoded, size_type begin,
+                      size_type end, size_type depth)
+    {
+        if (end - begin == 1)
+            return make_leaf(firsts[begin]);
+
+        /* Since the keys are sorted, the common prefix of the first and the last key is common to all keys.  Distinct
+         * keys of fixed length differ in some byte. */
+        const bytes_type &first = encoded[begin], &last = encoded[end - 1];
+        size_type prefix_length = 0;
+        while (first[depth + prefix_length] == last[depth + prefix_length])
+            ++prefix_length;
+        const size_type byte_pos = depth + prefix_length;
+
+        size_type num_children = 1;
+        for (size_type i = begin + 1; i != end; ++i)
+            num_children += encoded[i - 1][byte_pos] != encoded[i][byte_pos];
+
+        Node *node;
+        if (num_children <= 4)       node = new Node4();
+        else if (num_children <= 16) node = new Node16();
+        else if (num_children <= 48) node = new Node48();
+        else                         node = new Node256();
+        ++num_nodes_;
+        node->prefix_length = prefix_length;
+        std::copy_n(first.begin() + depth, std::min(prefix_length, MAX_PREFIX_LENGTH), node->prefix.begin());
+
+        for (size_type child_begin = begin; child_begin != end; ) {
+            const uint8_t byte = encoded[child_begin][byte_pos];
+            size_type child_end = child_begin + 1;
+            while (child_end != end and encoded[child_end][byte_pos] == byte)
+                ++child_end;
+            add_child_(node, byte, build_(firsts, encoded, child_begin, child_end, byte_pos + 1));
+            child_begin = child_end;
+        }
+        return reinterpret_cast<child_type>(node);
+    }
+
+    /** Adds \p child for the key \p byte to \p node.  Children must be added in ascending order of their bytes. */
+    static void add_child_(Node *node, uint8_t byte, child_type child) {
+        switch (node->type) {
+            case NODE4: {
+                Node4 *n = static_cast<Node4*>(node);
+                n->keys[n->num_children] = byte;
+                n->children[n->num_children] = child;
+                break;
+            }
+            case NODE16: {
+                Node16 *n = static_cast<Node16*>(node);
+                n->keys[n->num_children] = byte;
+                n->children[n->num_children] = child;
+                break;
+            }
+            case NODE48: {
+                Node48 *n = static_cast<Node48*>(node);
+                n->child_index[byte] = n->num_children + 1;
+                n->children[n->num_children] = child;
+                break;
+            }
+            case NODE256:
+                static_cast<Node256*>(node)->children[byte] = child;
+                break;
+        }
+        ++node->num_children;
+    }
+
+    /** Returns the child of \p node for the key \p byte, if any, and 0 otherwise. */
+    static child_type find_child_(const Node *node, uint8_t byte) {
+        switch (node->type) {
+            case NODE4: {
+                const Node4 *n = static_cast<const Node4*>(node);
+                for (size_type i = 0; i != n->num_children; ++i)
+                    if (n->keys[i] == byte) return n->children[i];
+                return 0;
+            }
+            case NODE16: {
+                const Node16 *n = static_cast<const Node16*>(node);
+#ifdef __SSE2__
+                /* Compare all 16 key bytes at once. */
+                const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(byte),
+                                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys.data())));
+                const unsigned mask = unsigned(_mm_movemask_epi8(cmp)) & ((1U << n->num_children) - 1);
+                return mask ? n->children[std::countr_zero(mask)] : 0;
+#else
+                for (size_type i = 0; i != n->num_children; ++i)
+                    if (n->keys[i] == byte) return n->children[i];
+                return 0;
+#endif
+            }
+            case NODE48: {
+                const Node48 *n = static_cast<const Node48*>(node);
+                const uint8_t idx = n->child_index[byte];
+                return idx ? n->children[idx - 1] : 0;
+            }
+            case NODE256:
+                return static_cast<const Node256*>(node)->children[byte];
+        }
+        M_unreachable("invalid node type");
+    }
+
+    /** Returns the child of \p node with the smallest key byte not less than \p byte, if any, and 0 otherwise. */
+    static child_type lower_child_(const Node *node, unsigned byte) {
+        switch (node->type) {
+            case NODE4:
+            case NODE16: {
+                auto scan = [byte](const auto *n) -> child_type {
+                    for (size_type i = 0; i != n->num_children; ++i)
+                        if (n->keys[i] >= byte) return n->children[i];
+                    return 0;
+                };
+                return node->type == NODE4 ? scan(static_cast<const Node4*>(node))
+                                           : scan(static_cast<const Node16*>(node));
+            }
+            case NODE48: {
+                const Node48 *n = static_cast<const Node48*>(node);
+                for (; byte < 256; ++byte)
+                    if (n->child_index[byte]) return n->children[n->child_index[byte] - 1];
+                return 0;
+            }
+            case NODE256: {
+                const Node256 *n = static_cast<const Node256*>(node);
+                for (; byte < 256; ++byte)
+                    if (n->children[byte]) return n->children[byte];
+                return 0;
+            }
+        }
+        M_unreachable("invalid node type");
+    }
+
+    /** Returns the index of the smallest pair in the subtree \p child. */
+    static size_type min_index_(child_type child) {
+        while (not is_leaf(child))
+            child = lower_child_(as_node(child), 0);
+        return leaf_index(child);
+    }
+
+    /** Returns the index of the first pair with the given \p key, if any, and `size()` otherwise. */
+    size_type find_(const key_type &key) const {
+        if (not root_) return size();
+        bytes_type encoded;
+        radix_key<key_type>::encode(key, encoded.data());
+
+        child_type child = root_;
+        size_type depth = 0;
+        while (not is_leaf(child)) {
+            const Node *node = as_node(child);
+            /* Compare the stored part of the prefix; the remainder is verified at the leaf. */
+            const size_type stored = std::min<size_type>(node->prefix_length, MAX_PREFIX_LENGTH);
+            if (std::memcmp(node->prefix.data(), encoded.data() + depth, stored) != 0)
+                return size();
+            depth += node->prefix_length;
+            child = find_child_(node, encoded[depth]);
+            if (not child) return size();
+            ++depth;
+        }
+        const size_type idx = leaf_index(child);
+        return keys_[idx] == key ? idx : size();
+    }
+
+    /** Returns the index of the first pair with key not less than \p key in the subtree \p child, whose keys share
+     * their first \p depth bytes with \p encoded, if any, and `size()` otherwise. */
+    size_type lower_bound_(child_type child, const key_type &key, const bytes_type &encoded, size_type depth) const {
+        if (is_leaf(child)) {
+            const size_type idx = leaf_index(child);
+            return keys_[idx] < key ? size() : idx;
+        }
+
+        const Node *node = as_node(child);
+        /* Compare the entire prefix.  If it is not fully stored in the node, take it from the smallest key. */
+        const uint8_t *prefix = node->prefix.data();
+        bytes_type smallest;
+        if (node->prefix_length > MAX_PREFIX_LENGTH) {
+            radix_key<key_type>::encode(keys_[min_index_(child)], smallest.data());
+            prefix = smallest.data() + depth;
+        }
+        const int cmp = std::memcmp(prefix, encoded.data() + depth, node->prefix_length);
+        if (cmp > 0) return min_index_(child); // all keys of the subtree are greater
+        if (cmp < 0) return size(); // all keys of the subtree are less
+        depth += node->prefix_length;
+
+        const uint8_t byte = encoded[depth];
+        if (child_type next = find_child_(node, byte)) {
+            const size_type idx = lower_bound_(next, key, encoded, depth + 1);
+            if (idx != size()) return idx;
+        }
+        if (child_type next = lower_child_(node, unsigned(byte) + 1))
+            return min_index_(next);
+        return size();
+    }
+
+    /** Returns the index of the first pair with key not less than \p key, if any, and `size()` otherwise. */
+    size_type lower_bound_(const key_type &key) const {
+        if (not root_) return size();
+        bytes_type encoded;
+        radix_key<key_type>::encode(key, encoded.data());
+        return lower_bound_(root_, key, encoded, 0);
+    }
+
+    std::pair<size_type, size_type> find_range_(const key_type &lo, const key_type &hi) const {
+        if (not (lo < hi)) return { size(), size() };
+        return { lower_bound_(lo), lower_bound_(hi) };
+    }
+
+    std::pair<size_type, size_type> equal_range_(const key_type &key) const {
+        const size_type begin = find_(key);
+        size_type end = begin;
+        while (end != size() and keys_[end] == key)
+            ++end;
+        return { begin, end };
+    }
+
+    static void delete_(child_type child) {
+        if (not child or is_leaf(child)) return;
+        Node *node = reinterpret_cast<Node*>(child);
+        switch (node->type) {
+            case NODE4: {
+                Node4 *n = static_cast<Node4*>(node);
+                std::for_each_n(n->children.begin(), n->num_children, delete_);
+                delete n;
+                break;
+            }
+            case NODE16: {
+                Node16 *n = static_cast<Node16*>(node);
+                std::for_each_n(n->children.begin(), n->num_children, delete_);
+                delete n;
+                break;
+            }
+            case NODE48: {
+                Node48 *n = static_cast<Node48*>(node);
+                std::for_each_n(n->children.begin(), n->num_children, delete_);
+                delete n;
+                break;
+            }
+            case NODE256: {
+                Node256 *n = static_cast<Node256*>(node);
+                std::for_each(n->children.begin(), n->children.end(), delete_);
+                delete n;
+                break;
+            }
+        }
+    }
+};
@@ -1,15 +1,20 @@
 #pragma once
 
 #include "mutable/util/macro.hpp"
+#include "histogram.hpp"
+#include "node_search.hpp"
+#include "radix_sort.hpp"
 #include <algorithm>
 #include <array>
 #include <vector>
 #include <bit>
 #include <cassert>
+#include <chrono>
 #include <concepts>
 #include <cstdint>
 #include <utility>
 #include <cstring>
+#include <thread>
 
 
 
@@ -48,12 +53,14 @@ ref_pair<First, Second> make_ref_pair(First &first, Second &second) {
 
 /** Implements a B+-tree of \tparam Key - \tparam Value pairs.  The exact size of a tree node is given as \tparam
  * NodeSizeInBytes and the exact node alignment is given as \tparam NodeAlignmentInBytes.  The implementation must
- * guarantee that nodes are properly allocated to satisfy the alignment. */
+ * guarantee that nodes are properly allocated to satisfy the alignment.  Keys within a node are located with the search
+ * policy \tparam Search (see `node_search.hpp`). */
 template<
     typename Key,
     std::movable Value,
     std::size_t NodeSizeInBytes,
-    std::size_t NodeAlignmentInBytes = NodeSizeInBytes
+    std::size_t NodeAlignmentInBytes = NodeSizeInBytes,
+    typename Search = linear_search
 >
 requires sortable<Key> and std::copyable<Key>
 struct BTree
@@ -70,6 +77,8 @@ struct BTree
     static constexpr size_type NODE_SIZE_IN_BYTES = NodeSizeInBytes;
     ///> the aignment of BTree nodes (both `INode` and `Leaf`)
     static constexpr size_type NODE_ALIGNMENT_IN_BYTES = NodeAlignmentInBytes;
+    ///> the policy to search keys within a node
+    using search_policy = Search;
 
     private:
     using key_value_type = ref_pair<const key_type, mapped_type>;
@@ -87,9 +96,21 @@ struct BTree
         metadata_size += sizeof(bool);
         // Size taken by size_type indicating the number of current keys in the leaf
         metadata_size += sizeof(size_type);
-        size_type entry_size = sizeof(key_value_type); //sizeof(key_type) + sizeof(mapped_type);
+        // Keys and values are stored in separate arrays, hence an entry takes exactly the size of a key and a value
+        size_type entry_size = sizeof(key_type) + sizeof(mapped_type);
         // calculate num_key_value_pairs
         size_type num_entries = (NODE_SIZE_IN_BYTES - metadata_size) / entry_size;
+        // reduce num_key_value_pairs until the fields fit, including the padding for their alignment
+        auto align = [](size_type offset, size_type alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        };
+        auto leaf_size = [&](size_type n) {
+            size_type offset = align(sizeof(bool), alignof(key_type)) + n * sizeof(key_type);
+            offset = align(offset, alignof(mapped_type)) + n * sizeof(mapped_type);
+            return align(offset, alignof(Leaf*)) + sizeof(Leaf*) + sizeof(size_type);
+        };
+        while (num_entries and leaf_size(num_entries) > NODE_SIZE_IN_BYTES)
+            --num_entries;
         return num_entries;
 
     };
@@ -116,6 +137,8 @@ struct BTree
     static constexpr size_type NUM_KEYS_PER_LEAF = compute_num_keys_per_leaf();
     ///> the number of keys per `INode`
     static constexpr size_type NUM_KEYS_PER_INODE = compute_num_keys_per_inode();
+    ///> the minimum number of subtrees `partition_range()` distributes over each part
+    static constexpr size_type PARTITIONS_PER_PART = 4;
 
     /** This class implements leaves of the B+-tree. */
     struct alignas(NODE_ALIGNMENT_IN_BYTES) Leaf : Node
@@ -182,6 +205,27 @@ struct BTree
             values_[n_keys_] = pair.second();
             n_keys_++;
         }
+
+        /** Inserts \p key and \p value at position \p pos of this leaf, which must not be full. */
+        void insert(size_type pos, key_type &key, mapped_type &value) {
+            std::move_backward(keys_.begin() + pos, keys_.begin() + n_keys_, keys_.begin() + n_keys_ + 1);
+            std::move_backward(values_.begin() + pos, values_.begin() + n_keys_, values_.begin() + n_keys_ + 1);
+            keys_[pos] = std::move(key);
+            values_[pos] = std::move(value);
+            n_keys_++;
+        }
+
+        /** Moves the upper half of the pairs of this leaf to the empty leaf \p right and links \p right after this
+         * leaf. */
+        void split(Leaf &right) {
+            const size_type half = (n_keys_ + 1) / 2;
+            std::move(keys_.begin() + half, keys_.begin() + n_keys_, right.keys_.begin());
+            std::move(values_.begin() + half, values_.begin() + n_keys_, right.values_.begin());
+            right.n_keys_ = n_keys_ - half;
+            n_keys_ = half;
+            right.next_ = next_;
+            next_ = &right;
+        }
     };
     static_assert(sizeof(Leaf) <= NODE_SIZE_IN_BYTES, "Leaf exceeds its size limit");
 
@@ -248,6 +292,43 @@ struct BTree
             pointers_[n_keys_] = pointer;
             n_keys_++;
         }
+
+        /** Inserts \p child, whose smallest key is \p separator, as the child at position \p index > 0 of this node,
+         * which must not be full. */
+        void insert_child(size_type index, key_type &separator, pointer_type child) {
+            for (size_type i = n_keys_; i > index; --i) {
+                pointers_[i] = pointers_[i - 1];
+                keys_[i - 1] = std::move(keys_[i - 2]);
+            }
+            keys_[index - 1] = std::move(separator);
+            pointers_[index] = child;
+            n_keys_++;
+        }
+
+        /** Inserts \p child, whose smallest key is \p separator, as the child at position \p index > 0 of this full
+         * node, and moves the upper half of the children to the empty node \p right.  Stores the smallest key of \p
+         * right in \p separator. */
+        void split(size_type index, key_type &separator, pointer_type child, INode &right) {
+            /* Insert into temporary arrays of one more child, then distribute. */
+            std::array<key_type, NUM_KEYS_PER_INODE + 1> keys;
+            std::array<pointer_type, NUM_KEYS_PER_INODE + 2> pointers;
+            std::move(keys_.begin(), keys_.begin() + (index - 1), keys.begin());
+            keys[index - 1] = std::move(separator);
+            std::move(keys_.begin() + (index - 1), keys_.begin() + (n_keys_ - 1), keys.begin() + index);
+            std::copy(pointers_.begin(), pointers_.begin() + index, pointers.begin());
+            pointers[index] = child;
+            std::copy(pointers_.begin() + index, pointers_.begin() + n_keys_, pointers.begin() + index + 1);
+
+            const size_type num_children = n_keys_ + 1;
+            const size_type half = (num_children + 1) / 2;
+            std::move(keys.begin(), keys.begin() + (half - 1), keys_.begin());
+            std::copy(pointers.begin(), pointers.begin() + half, pointers_.begin());
+            n_keys_ = half;
+            separator = std::move(keys[half - 1]);
+            std::move(keys.begin() + half, keys.begin() + (num_children - 1), right.keys_.begin());
+            std::copy(pointers.begin() + half, pointers.begin() + num_children, right.pointers_.begin());
+            right.n_keys_ = num_children - half;
+        }
         private:
         const key_type get_last_key_ (Node *node) {
             if(node->leaf) {
@@ -365,41 +446,52 @@ struct BTree
     size_type height_;
     Leaf *first_leaf_, *last_leaf_;
     size_type first_key_idx_, last_key_idx_;
+    ///> the keys of every leaf but the last, if the tree is bulkloaded and not modified since, and 0 otherwise
+    size_type keys_per_leaf_;
+    ///> the children of every inner node but the last of its level, if `keys_per_leaf_` is not 0
+    size_type children_per_inode_;
 
 
 
     public:
     /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive) into a fresh `BTree` and returns
-     * it. */
+     * it.  Every leaf but the last is filled to the fraction \p leaf_fill of its capacity and every inner node but the
+     * last of its level to the fraction \p inode_fill, both in `(0, 1]`.  Filling nodes completely is optimal for
+     * read-only data; leaving room in the nodes lets subsequent `insert()`s proceed without splitting. */
     template<typename It>
-    static BTree Bulkload(It begin, It end)
+    static BTree Bulkload(It begin, It end, double leaf_fill = 1., double inode_fill = 1.)
     requires requires (It it) {
         key_type(std::move(it->first));
         mapped_type(std::move(it->second));
     }
     {
         /* TODO 1.4.4 */
+        M_insist(0 < leaf_fill and leaf_fill <= 1, "leaf fill factor must be in (0, 1]");
+        M_insist(0 < inode_fill and inode_fill <= 1, "inode fill factor must be in (0, 1]");
         size_type size = std::distance(begin, end);
         if (size == 0) return BTree();
         
         Leaf *first_leaf, *last_leaf;
-        size_type const keys_per_leaf = NUM_KEYS_PER_LEAF;
+        size_type const keys_per_leaf = std::clamp<size_type>(leaf_fill * NUM_KEYS_PER_LEAF, 1, NUM_KEYS_PER_LEAF);
+        size_type const children_per_inode =
+            std::clamp<size_type>(inode_fill * (NUM_KEYS_PER_INODE + 1), 2, NUM_KEYS_PER_INODE + 1);
         size_type num_leaves = size / keys_per_leaf + (size % keys_per_leaf != 0);
-        size_type height = num_leaves > 1 ? 1 : 0;
+        size_type height = 0; // incremented for every level of inner nodes
 
         std::vector<Node*> inodes, leaves, children;
+        leaves.reserve(num_leaves);
         Leaf * current_leaf = new Leaf();
         first_leaf = current_leaf;
         for (It it = begin; it != end; ++it) {
             // if current_leaf is full, create the next leaf and point it
-            if(current_leaf->is_full()) {
+            if(current_leaf->size() == keys_per_leaf) {
                 Leaf *new_leaf = new Leaf();
                 current_leaf->next(new_leaf);
                 leaves.push_back(current_leaf);
                 current_leaf = new_leaf;
             }
             // add ref_pairs to current leave
-            current_leaf->add_key_value(make_ref_pair(it->first, const_cast<mapped_type&>(it->second)));
+            current_leaf->add_key_value(make_ref_pair(std::as_const(it->first), const_cast<mapped_type&>(it->second)));
         }
         leaves.push_back(current_leaf);
         last_leaf = current_leaf;
@@ -410,7 +502,7 @@ struct BTree
             height++;
             for (size_type i = 0; i < children.size(); i++) {
                 // if inode is full create new and add them to inodes temporal (next children)
-                if (current_inode->is_full()) {
+                if (current_inode->size() == children_per_inode) {
                     INode *new_inode = new INode();
                     inodes.push_back(current_inode);
                     current_inode = new_inode;
@@ -424,7 +516,49 @@ struct BTree
             children = inodes;
             inodes.clear();
             }        
-        return BTree(children.front(), size, height, first_leaf, last_leaf);
+        return BTree(children.front(), size, height, first_leaf, last_leaf, keys_per_leaf, children_per_inode);
+    }
+
+    /** The wall-clock times of the two phases of `BulkloadUnsorted()`, in milliseconds. */
+    struct bulkload_times
+    {
+        double sort_ms = 0;
+        double build_ms = 0;
+    };
+
+    /** Sorts the data in the range from `begin` (inclusive) to `end` (exclusive), which need not be sorted, in place
+     * by key and bulkloads it into a fresh `BTree`, which is returned.  Integral keys are sorted with a parallel radix
+     * sort on \p num_threads threads, other keys with a comparison sort; see `sort_by_key()`.  Pairs with equal keys
+     * keep their relative order.  If \p times is not `nullptr`, the times of sorting and building are stored in
+     * `*times`. */
+    template<std::random_access_iterator It>
+    static BTree BulkloadUnsorted(It begin, It end, std::size_t num_threads = std::thread::hardware_concurrency(),
+                                  bulkload_times *times = nullptr)
+    requires requires (It it) {
+        key_type(std::move(it->first));
+        mapped_type(std::move(it->second));
+    }
+    {
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+
+        /* Stores the build time when leaving the scope, i.e. after the tree was built.  The prvalue `Bulkload(...)`
+         * is returned by guaranteed copy elision, hence it is built directly in the caller's object before the timer
+         * is destroyed.  Do not store the tree in a local variable first:  the implicit copy constructor of `BTree`
+         * copies the node pointers shallowly, and the copy and the local would free the same nodes. */
+        struct build_timer
+        {
+            bulkload_times *times;
+            clock::time_point start;
+            ~build_timer() { if (times) times->build_ms = ms(clock::now() - start).count(); }
+        };
+
+        const auto t_begin = clock::now();
+        sort_by_key(begin, end, [](auto &pair) -> const auto & { return pair.first; }, num_threads);
+        const auto t_sorted = clock::now();
+        if (times) times->sort_ms = ms(t_sorted - t_begin).count();
+        build_timer timer{ times, t_sorted };
+        return Bulkload(begin, end);
     }
 
     private:
@@ -434,10 +568,13 @@ struct BTree
         root_ = first_leaf_ = last_leaf_ = new_leaf;
         size_ = height_ = 0;
         first_key_idx_ = last_key_idx_ = 0;
+        keys_per_leaf_ = NUM_KEYS_PER_LEAF;
+        children_per_inode_ = NUM_KEYS_PER_INODE + 1;
 
     }
     /* C'tor */
-    BTree(Node* root, size_type size, size_type height, Leaf *first_leaf, Leaf *last_leaf) {
+    BTree(Node* root, size_type size, size_type height, Leaf *first_leaf, Leaf *last_leaf, size_type keys_per_leaf,
+          size_type children_per_inode) {
         root_ = root;
         size_ = size;
         height_ = height;
@@ -445,6 +582,8 @@ struct BTree
         last_leaf_ = last_leaf;
         first_key_idx_ = 0;
         last_key_idx_ = (last_leaf->size() ?  last_leaf->size() - 1 : 0);
+        keys_per_leaf_ = keys_per_leaf;
+        children_per_inode_ = children_per_inode;
     }
 
     /* Des'tor */
@@ -467,6 +606,195 @@ struct BTree
     ///> returns the number if inner/non-leaf levels, a.k.a. the height
     size_type height() const { /* TODO 1.4.2 */ return height_; }
 
+    /** Structural statistics of one level of the tree. */
+    struct level_stats
+    {
+        size_type num_nodes = 0;
+        size_type num_entries = 0; ///< the number of key-value pairs of leaves, the number of children of inner nodes
+        double avg_fill = 0; ///< the average fraction of the entries of a node that are occupied
+        double min_fill = 0; ///< the minimum fraction of the entries of a node that are occupied
+    };
+
+    /** Structural statistics and memory accounting of a tree, see `stats()`. */
+    struct tree_stats
+    {
+        std::vector<level_stats> levels; ///< the statistics per level, from the root level to the leaf level
+        size_type num_inodes = 0;
+        size_type num_leaves = 0;
+        size_type total_bytes = 0; ///< the bytes of all nodes
+        size_type padding_bytes = 0; ///< the bytes of all nodes not covered by their fields, due to the node alignment
+        size_type unused_bytes = 0; ///< the bytes of all entries of nodes that are not occupied
+        double bytes_per_key = 0; ///< `total_bytes` divided by the number of key-value pairs
+
+        ///> returns the statistics of the leaf level
+        const level_stats & leaves() const { return levels.back(); }
+    };
+
+    ///> the bytes of a `Leaf` not covered by its fields
+    static constexpr size_type LEAF_PADDING_IN_BYTES = sizeof(Leaf) - sizeof(Node) - sizeof(typename Leaf::keys_type)
+        - sizeof(typename Leaf::values_type) - sizeof(Leaf*) - sizeof(size_type);
+    ///> the bytes of an `INode` not covered by its fields
+    static constexpr size_type INODE_PADDING_IN_BYTES = sizeof(INode) - sizeof(Node)
+        - sizeof(typename INode::keys_type) - sizeof(typename INode::pointers_type) - sizeof(size_type);
+
+    /** Returns the number of nodes and their fill factor per level, and accounts for the memory of the tree.  Traverses
+     * the entire tree. */
+    tree_stats stats() const {
+        constexpr size_type BYTES_PER_LEAF_ENTRY = sizeof(key_type) + sizeof(mapped_type);
+        constexpr size_type BYTES_PER_INODE_ENTRY = sizeof(key_type) + sizeof(pointer_type);
+
+        tree_stats stats;
+        std::vector<const Node*> level{ root_ }, next_level;
+        while (not level.empty()) {
+            level_stats &ls = stats.levels.emplace_back();
+            ls.num_nodes = level.size();
+            ls.min_fill = 1;
+            double sum_fill = 0;
+            for (const Node *node : level) {
+                size_type num_entries, capacity;
+                if (node->leaf) {
+                    const Leaf *leaf = static_cast<const Leaf*>(node);
+                    num_entries = leaf->size();
+                    capacity = NUM_KEYS_PER_LEAF;
+                    stats.unused_bytes += (capacity - num_entries) * BYTES_PER_LEAF_ENTRY;
+                } else {
+                    const INode *inode = static_cast<const INode*>(node);
+                    num_entries = inode->size();
+                    capacity = NUM_KEYS_PER_INODE + 1;
+                    stats.unused_bytes += (capacity - num_entries) * BYTES_PER_INODE_ENTRY;
+                    for (size_type i = 0; i != inode->size(); ++i)
+                        next_level.push_back(inode->pointers_[i]);
+                }
+                const double fill = double(num_entries) / capacity;
+                ls.num_entries += num_entries;
+                sum_fill += fill;
+                ls.min_fill = std::min(ls.min_fill, fill);
+            }
+            ls.avg_fill = sum_fill / ls.num_nodes;
+            (level.front()->leaf ? stats.num_leaves : stats.num_inodes) += ls.num_nodes;
+            level.swap(next_level);
+            next_level.clear();
+        }
+
+        stats.total_bytes = stats.num_leaves * sizeof(Leaf) + stats.num_inodes * sizeof(INode);
+        stats.padding_bytes = stats.num_leaves * LEAF_PADDING_IN_BYTES + stats.num_inodes * INODE_PADDING_IN_BYTES;
+        stats.bytes_per_key = size_ ? double(stats.total_bytes) / size_ : 0;
+        return stats;
+    }
+
+    /** Derives an equi-depth histogram with (at most) \p num_buckets buckets of the keys of the tree.  Only the keys
+     * at the bucket boundaries are read, besides the keys of at most \p num_sampled_leaves_per_bucket leaves per
+     * bucket, evenly spread over the bucket, to estimate the number of distinct keys of the bucket from the fraction of
+     * adjacent keys that differ.  If a bucket spans no more leaves, its distinct keys are counted exactly.  The leaf
+     * holding a key of a given rank is found by descending from the root, since all nodes but the last of every level
+     * of a bulkloaded tree are filled alike.  Hence, the time is linear in the number of buckets times the sampled
+     * leaves and the height, but independent of the size of the tree.  After `insert()`, the nodes are no longer
+     * filled alike and the leaves are collected first, which takes time linear in the number of leaves. */
+    equi_depth_histogram<key_type> histogram(size_type num_buckets, size_type num_sampled_leaves_per_bucket = 8) const {
+        equi_depth_histogram<key_type> histogram;
+        histogram.num_keys = size_;
+        if (size_ == 0 or num_buckets == 0) return histogram;
+        num_buckets = std::min(num_buckets, size_);
+
+        /* Unless the tree is bulkloaded, collect the leaves and the rank of the first key of every leaf. */
+        const bool bulkloaded = keys_per_leaf_ != 0;
+        std::vector<const Leaf*> leaves;
+        std::vector<size_type> offsets; // the rank of the first key of every leaf
+        if (not bulkloaded) {
+            size_type offset = 0;
+            for (const Leaf *leaf = first_leaf_; leaf; leaf = leaf->next_) {
+                leaves.push_back(leaf);
+                offsets.push_back(offset);
+                offset += leaf->size();
+            }
+        }
+
+        /* Returns the index of the leaf holding the key of rank `rank`. */
+        auto leaf_of = [&](size_type rank) -> size_type {
+            if (bulkloaded) return rank / keys_per_leaf_;
+            return std::upper_bound(offsets.begin(), offsets.end(), rank) - offsets.begin() - 1;
+        };
+        /* Returns the leaf of index `l`. */
+        auto leaf_at = [&](size_type l) -> const Leaf & { return bulkloaded ? bulkloaded_leaf(l) : *leaves[l]; };
+        /* Returns the rank of the first key of the leaf of index `l`. */
+        auto offset_of = [&](size_type l) -> size_type { return bulkloaded ? l * keys_per_leaf_ : offsets[l]; };
+        auto key_at = [&](size_type rank) -> const key_type & {
+            const size_type l = leaf_of(rank);
+            return leaf_at(l).keys_[rank - offset_of(l)];
+        };
+        /* Counts the pairs of adjacent keys with ranks in `[begin, end)` and how many of them differ. */
+        auto count_changes = [&](size_type begin, size_type end, size_type &num_pairs, size_type &num_changes) {
+            if (begin + 1 >= end) return;
+            size_type l = leaf_of(begin + 1);
+            const Leaf *leaf = &leaf_at(l);
+            size_type offset = offset_of(l);
+            const key_type *prev = &key_at(begin);
+            for (size_type rank = begin + 1; rank < end; ) {
+                const size_type last = std::min(end, offset + leaf->size());
+                for (; rank < last; ++rank) {
+                    const key_type &current = leaf->keys_[rank - offset];
+                    ++num_pairs;
+                    num_changes += not (*prev == current);
+                    prev = &current;
+                }
+                /* Continue with the next leaf. */
+                offset += leaf->size();
+                leaf = leaf->next_;
+            }
+        };
+
+        for (size_type b = 0; b != num_buckets; ++b) {
+            const size_type begin = b * size_ / num_buckets;
+            const size_type end = (b + 1) * size_ / num_buckets;
+            auto &bucket = histogram.buckets.emplace_back(typename equi_depth_histogram<key_type>::bucket{
+                .lo = key_at(begin), .hi = key_at(end - 1), .count = end - begin, .num_distinct = 1 });
+
+            const size_type first_leaf = leaf_of(begin), last_leaf = leaf_of(end - 1);
+            const size_type num_leaves = last_leaf - first_leaf + 1;
+            size_type num_pairs = 0, num_changes = 0;
+            if (num_leaves <= num_sampled_leaves_per_bucket) {
+                count_changes(begin, end, num_pairs, num_changes);
+                bucket.num_distinct = 1 + num_changes;
+            } else {
+                for (size_type i = 0; i != num_sampled_leaves_per_bucket; ++i) {
+                    const size_type l = first_leaf + (2 * i + 1) * num_leaves / (2 * num_sampled_leaves_per_bucket);
+                    /* Include the pair of the first key of the leaf and the last key of the previous leaf. */
+                    const size_type offset = offset_of(l);
+                    const size_type first = offset ? offset - 1 : 0;
+                    const size_type last = offset + leaf_at(l).size();
+                    count_changes(std::max(begin, first), std::min(end, last), num_pairs, num_changes);
+                }
+                bucket.num_distinct = 1 + (num_pairs ? double(num_changes) / num_pairs * (bucket.count - 1) : 0);
+            }
+            histogram.num_distinct += bucket.num_distinct;
+            /* Do not count a key twice that spans the boundary to the previous bucket. */
+            if (b != 0 and histogram.buckets[b - 1].hi == bucket.lo) histogram.num_distinct -= 1;
+        }
+        return histogram;
+    }
+
+    /** Inserts the pair of \p key and \p value into the tree.  The pair is inserted after all pairs with equal key in
+     * its leaf.  A full leaf is split in halves; the split propagates upwards through full inner nodes and, if the
+     * root splits, adds a level to the tree.  Invalidates all iterators. */
+    void insert(key_type key, mapped_type value) {
+        key_type separator;
+        if (Node *right = insert_(root_, key, value, separator)) {
+            /* The root split, grow a new root. */
+            INode *root = new INode();
+            root->pointers_[0] = root_;
+            root->pointers_[1] = right;
+            root->keys_[0] = std::move(separator);
+            root->n_keys_ = 2;
+            root_ = root;
+            ++height_;
+        }
+        ++size_;
+        keys_per_leaf_ = children_per_inode_ = 0; // the nodes are no longer filled alike
+        while (last_leaf_->has_next())
+            last_leaf_ = &last_leaf_->next();
+        last_key_idx_ = last_leaf_->size() - 1;
+    }
+
     /** Returns an `iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
     iterator begin() { /* TODO 1.4.3 */ return iterator(first_leaf_, first_key_idx_); }
     /** Returns the past-the-end `iterator`. */
@@ -488,7 +816,7 @@ struct BTree
     const_iterator find(const key_type &key) const {
         /* TODO 1.4.5 */
         if (size_ < 1) return cend();
-        std::pair<Leaf*, size_type> result = find_(key, root_);
+        std::pair<Leaf*, size_type> result = find_(key);
         if (result.first == nullptr) {
             return cend();
         } else {
@@ -499,7 +827,7 @@ struct BTree
     iterator find(const key_type &key) {
         /* TODO 1.4.5 */
         if (size_ < 1) return end();
-        std::pair<Leaf*, size_type> result = find_(key, root_);
+        std::pair<Leaf*, size_type> result = find_(key);
         if (result.first == nullptr) {
             return end();
         } else {
@@ -514,15 +842,16 @@ struct BTree
     const_range find_range(const key_type &lo, const key_type &hi) const {
         /* TODO 1.4.6 */
         if (size_ < 1) {
-            return const_range(iterator(nullptr, nullptr), iterator(nullptr, nullptr));
+            return const_range(end(), end());
         }
 
-        the_iterator begin_it = find_lower_key(lo, root_);
+        auto [leaf, i] = lower_bound_(lo);
+        const_iterator begin_it = i == leaf->size() ? end() : const_iterator(leaf, i);
         if ((begin_it == end()) || ((*begin_it).first() >= hi)) {
-            return const_range(iterator(nullptr, nullptr), iterator(nullptr, nullptr));
+            return const_range(end(), end());
         }
 
-        the_iterator end_it = begin_it;
+        const_iterator end_it = begin_it;
         while (!(end_it == end())) {
             if (((*end_it).first()) >= hi) {
                 break;
@@ -539,7 +868,7 @@ struct BTree
             return range(end(), end());
         }
 
-        iterator begin_it = find_lower_key(lo, root_);
+        iterator begin_it = find_lower_key(lo);
         if ((begin_it == end()) || ((*begin_it).first() >= hi)) {
             return range(end(), end());
         }
@@ -565,64 +894,176 @@ struct BTree
         return find_range(key, key+1);
     }
 
-    private:
-    std::pair<Leaf*, size_type> find_ (const key_type &key, Node* root) const {
-        Node* current_node = root;
-        while (!(current_node->leaf)) {
-            INode* inode = static_cast<INode*>(current_node);
-            size_type index = 0;
-            bool found = false;
-            auto inode_keys = inode->keys();
-            size_type inode_size = inode->size();
-            for (index = 0; index < inode_size - 1; index++) {
-                if (key < inode_keys[index]) {
-                    found = true;
-                    break;
+    /** Splits the interval `[lo, hi)` into at most \p num_parts consecutive subintervals at inner-node boundaries and
+     * returns the keys at which the interval is split, in ascending order.  The subintervals are `[lo, s_0)`, `[s_0,
+     * s_1)`, ..., `[s_n, hi)`.  Since the split keys are taken from the separators of the nodes of a single level, the
+     * subintervals are balanced by the size of the subtrees they cover. */
+    std::vector<key_type> partition_range(const key_type &lo, const key_type &hi, size_type num_parts) const {
+        std::vector<key_type> splits;
+        if (size_ < 1 or num_parts < 2 or not (lo < hi)) return splits;
+
+        /* Descend level by level, keeping only the nodes overlapping `[lo, hi)`, until the frontier is fine-grained
+         * enough to be divided evenly.  Each node is paired with the smallest key it may contain. */
+        std::vector<std::pair<const Node*, key_type>> frontier{ { root_, lo } };
+        while (frontier.size() < PARTITIONS_PER_PART * num_parts and not frontier.front().first->leaf) {
+            std::vector<std::pair<const Node*, key_type>> next;
+            for (auto [node, low] : frontier) {
+                const INode *inode = static_cast<const INode*>(node);
+                for (size_type i = 0; i != inode->size(); ++i) {
+                    key_type child_low = i == 0 ? low : inode->keys_[i - 1];
+                    if (i != 0 and not (child_low < hi)) break; // child lies entirely right of `hi`
+                    if (i + 1 != inode->size() and inode->keys_[i] < lo) continue; // child lies entirely left of `lo`
+                    next.emplace_back(inode->pointers_[i], lo < child_low ? child_low : lo);
                 }
             }
-            current_node = inode->pointer(found ? index : inode->size() - 1);
+            frontier = std::move(next);
         }
 
-        Leaf* leaf = static_cast<Leaf*>(current_node);
-        auto leaf_keys = leaf->keys();
-        size_type leaf_size = leaf->size();
-        for (size_type i = 0; i < leaf_size; i++) {
-            if (leaf_keys[i] == key) {
-                return std::make_pair(leaf, i);
+        /* Divide the frontier into `num_parts` groups of consecutive subtrees and split at the first key of each
+         * group. */
+        const size_type num_groups = std::min(num_parts, frontier.size());
+        for (size_type g = 1; g != num_groups; ++g) {
+            const key_type &split = frontier[g * frontier.size() / num_groups].second;
+            if (lo < split and split < hi and (splits.empty() or splits.back() < split))
+                splits.push_back(split);
+        }
+        return splits;
+    }
+
+    /** Scans all elements with key in the interval `[lo, hi)` with \p num_threads threads in parallel.  The interval is
+     * partitioned with `partition_range()` and each part is scanned by its own thread, which folds the elements of its
+     * part into a private accumulator, initialized with \p init, by calling `fold(acc, key, value)`.  Finally, the
+     * accumulators are combined in key order with `acc = combine(acc, other)`.  \p init must be neutral w.r.t. \p
+     * combine. */
+    template<typename T, typename Fold, typename Combine>
+    T parallel_scan(const key_type &lo, const key_type &hi, size_type num_threads, T init, Fold fold,
+                    Combine combine) const
+    {
+        const std::vector<key_type> splits = partition_range(lo, hi, num_threads);
+        const size_type num_parts = splits.size() + 1;
+
+        std::vector<T> partials(num_parts, init);
+        std::vector<std::thread> threads;
+        threads.reserve(num_parts - 1);
+        for (size_type i = 1; i != num_parts; ++i) {
+            threads.emplace_back([&, i]() {
+                scan_(splits[i - 1], i == splits.size() ? hi : splits[i], partials[i], fold);
+            });
+        }
+        scan_(lo, splits.empty() ? hi : splits.front(), partials.front(), fold); // first part on the calling thread
+        for (auto &t : threads)
+            t.join();
+
+        T result = std::move(init);
+        for (auto &partial : partials)
+            result = combine(std::move(result), std::move(partial));
+        return result;
+    }
+
+    private:
+    /** Inserts \p key and \p value into the subtree rooted at \p node.  If \p node splits, returns its new right
+     * sibling and stores the smallest key of the sibling in \p separator, and returns `nullptr` otherwise. */
+    Node * insert_(Node *node, key_type &key, mapped_type &value, key_type &separator) {
+        if (node->leaf) {
+            Leaf *leaf = static_cast<Leaf*>(node);
+            size_type pos = std::upper_bound(leaf->keys_.begin(), leaf->keys_.begin() + leaf->size(), key)
+                          - leaf->keys_.begin();
+            if (not leaf->is_full()) {
+                leaf->insert(pos, key, value);
+                return nullptr;
             }
+            Leaf *right = new Leaf();
+            leaf->split(*right);
+            if (pos <= leaf->size())
+                leaf->insert(pos, key, value);
+            else
+                right->insert(pos - leaf->size(), key, value);
+            separator = right->keys_[0];
+            return right;
+        }
+
+        /* Descend as `lower_bound_()` does, such that the pair is found by `find()`. */
+        INode *inode = static_cast<INode*>(node);
+        const size_type index = Search::lower_bound(inode->keys_.data(), inode->size() - 1, key);
+        Node *child = insert_(inode->pointers_[index], key, value, separator);
+        if (not child) return nullptr;
+        if (not inode->is_full()) {
+            inode->insert_child(index + 1, separator, child);
+            return nullptr;
+        }
+        INode *right = new INode();
+        inode->split(index + 1, separator, child, *right);
+        return right;
+    }
+
+    std::pair<Leaf*, size_type> find_ (const key_type &key) const {
+        // descend to the first element not less than `key`, which may reside in a leaf left of the separator `key` if
+        // the duplicates of `key` span multiple leaves
+        auto [leaf, i] = lower_bound_(key);
+        if (i < leaf->size() and leaf->keys_[i] == key) {
+            return std::make_pair(const_cast<Leaf*>(leaf), i);
         }
         return std::make_pair(nullptr, 0);
     }
 
-    iterator find_lower_key(const key_type& key, Node* root) {
-        Node* current_node = root;
+    iterator find_lower_key(const key_type& key) {
+        auto [leaf, i] = lower_bound_(key);
+        if (i == leaf->size()) {
+            return end();
+        }
+        return iterator(const_cast<Leaf*>(leaf), i);
+    }
+
+    /** Returns the leaf and the index within that leaf of the first element with key not less than \p key.  If there is
+     * no such element, the returned index equals the size of the returned leaf. */
+    std::pair<const Leaf*, size_type> lower_bound_(const key_type &key) const {
+        const Node *current_node = root_;
         while (!(current_node->leaf)) {
-            INode* inode = static_cast<INode*>(current_node);
-            size_type index = 0;
-            bool found = false;
-            for (index = 0; index < inode->size() - 1; index++) {
-                if (key <= inode->keys()[index]) {
-                    found = true;
-                    break;
-                }
-            }
-            current_node = inode->pointer(found ? index : inode->size() - 1);
+            const INode *inode = static_cast<const INode*>(current_node);
+            // the first child whose separator is not less than `key`, if any, and the last child otherwise
+            size_type index = Search::lower_bound(inode->keys_.data(), inode->size() - 1, key);
+            current_node = inode->pointers_[index];
         }
-        Leaf* leaf = static_cast<Leaf*>(current_node);
-        for (size_type i = 0; i < leaf->size(); i++) {
-            if (leaf->keys()[i] >= key) {
-                return iterator(leaf, i);
-            }
+        const Leaf *leaf = static_cast<const Leaf*>(current_node);
+        size_type i = Search::lower_bound(leaf->keys_.data(), leaf->size(), key);
+        if (i == leaf->size() and leaf->has_next()) {
+            leaf = &leaf->next();
+            i = 0;
         }
-        // try in next leaf
-        if (leaf->has_next()) {
-            Leaf *next_leaf = &leaf->next();
-            for (size_type i = 0; i < next_leaf->size(); i++) {
-                if (next_leaf->keys()[i] >= key) {
-                    return iterator(next_leaf, i);
-                }
+        return std::make_pair(leaf, i);
+    }
+
+    /** Returns the \p l-th leaf of a bulkloaded tree, in which every leaf but the last holds `keys_per_leaf_` keys and
+     * every inner node but the last of its level `children_per_inode_` children.  Hence, every child but the last of
+     * an inner node spans the same number of leaves, and the child spanning the \p l-th leaf is computed rather than
+     * searched. */
+    const Leaf & bulkloaded_leaf(size_type l) const {
+        M_insist(keys_per_leaf_ != 0, "the tree must be bulkloaded");
+        size_type span = 1; // the number of leaves spanned by every child but the last of the current node
+        for (size_type h = 1; h < height_; ++h)
+            span *= children_per_inode_;
+        const Node *current_node = root_;
+        while (!(current_node->leaf)) {
+            const INode *inode = static_cast<const INode*>(current_node);
+            current_node = inode->pointers_[l / span];
+            l %= span;
+            span /= children_per_inode_;
+        }
+        return *static_cast<const Leaf*>(current_node);
+    }
+
+    /** Folds all elements with key in `[lo, hi)` into \p acc by calling `fold(acc, key, value)`. */
+    template<typename T, typename Fold>
+    void scan_(const key_type &lo, const key_type &hi, T &acc, Fold &fold) const {
+        auto [leaf, i] = lower_bound_(lo);
+        for (;;) {
+            for (; i < leaf->size(); ++i) {
+                if (not (leaf->keys_[i] < hi)) return;
+                fold(acc, leaf->keys_[i], leaf->values_[i]);
             }
+            if (not leaf->has_next()) return;
+            leaf = &leaf->next();
+            i = 0;
         }
-        return end();
     }
 };
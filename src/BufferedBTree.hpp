@@ -0,0 +1,453 @@
+#pragma once
+
+#include "BTree.hpp"
+#include <optional>
+
+
+/** Implements a write-optimized B^ε-tree mapping unique \tparam Key s to \tparam Value s.  Every inner node reserves
+ * \tparam BufferSizeInBytes of its \tparam NodeSizeInBytes for a buffer of pending insert and erase messages.  Updates
+ * are put into the buffer of the root and are only pushed one level down, in a batch with all other messages for the
+ * same child, once a buffer overflows.  Point lookups consult the buffers along the root-to-leaf path.  With a buffer
+ * size of zero, every update is applied to its leaf right away, as in a plain B+-tree.  Nodes are split when they
+ * overflow but never merged; leaves emptied by erasures are kept. */
+template<
+    typename Key,
+    std::copyable Value,
+    std::size_t NodeSizeInBytes,
+    std::size_t BufferSizeInBytes = NodeSizeInBytes / 2
+>
+requires sortable<Key> and std::copyable<Key>
+struct BufferedBTree
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    ///> the size of tree nodes (both `INode` and `Leaf`)
+    static constexpr size_type NODE_SIZE_IN_BYTES = NodeSizeInBytes;
+    ///> the size of the message buffer of an `INode`
+    static constexpr size_type BUFFER_SIZE_IN_BYTES = BufferSizeInBytes;
+
+    private:
+    struct Node
+    {
+        bool leaf;
+        size_type size; ///< number of entries of a `Leaf`, number of children of an `INode`
+    };
+
+    /** A pending update: inserts or overwrites the value of `key` unless `erase` is set, in which case it erases
+     * `key`. */
+    struct message
+    {
+        key_type key;
+        mapped_type value;
+        bool erase;
+    };
+
+    ///> returns \p offset rounded up to a multiple of \p alignment
+    static constexpr size_type align_up(size_type offset, size_type alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /** Returns the size of a `Leaf` with \p n pairs, including the padding between and after its fields. */
+    static constexpr size_type leaf_size(size_type n) {
+        size_type size = align_up(sizeof(Node), alignof(key_type)) + n * sizeof(key_type);
+        size = align_up(size, alignof(mapped_type)) + n * sizeof(mapped_type);
+        return align_up(size, std::max({ alignof(Node), alignof(key_type), alignof(mapped_type) }));
+    }
+
+    /** Returns the size of an `INode` with \p n children, including the padding between and after its fields.  The
+     * header of an `INode` is its `Node` and `num_messages`.  The buffer takes space even if it holds no message. */
+    static constexpr size_type inode_size(size_type n) {
+        using messages_type = std::array<message, BUFFER_SIZE_IN_BYTES / sizeof(message)>;
+        size_type size = align_up(sizeof(Node) + sizeof(size_type), alignof(key_type)) + (n - 1) * sizeof(key_type);
+        size = align_up(size, alignof(Node*)) + n * sizeof(Node*);
+        size = align_up(size, alignof(messages_type)) + sizeof(messages_type);
+        return align_up(size, std::max({ alignof(Node), alignof(key_type), alignof(Node*), alignof(messages_type) }));
+    }
+
+    static constexpr size_type compute_num_keys_per_leaf() {
+        size_type n = (NODE_SIZE_IN_BYTES - sizeof(Node)) / (sizeof(key_type) + sizeof(mapped_type));
+        while (n != 0 and leaf_size(n) > NODE_SIZE_IN_BYTES)
+            --n;
+        return n;
+    }
+    static constexpr size_type compute_num_children_per_inode() {
+        if (NODE_SIZE_IN_BYTES < BUFFER_SIZE_IN_BYTES + sizeof(Node) + sizeof(size_type)) return 0;
+        size_type n = (NODE_SIZE_IN_BYTES - BUFFER_SIZE_IN_BYTES - sizeof(Node) - sizeof(size_type) + sizeof(key_type))
+                      / (sizeof(key_type) + sizeof(Node*));
+        while (n > 1 and inode_size(n) > NODE_SIZE_IN_BYTES)
+            --n;
+        return n;
+    }
+
+    public:
+    ///> the number of key-value pairs per `Leaf`
+    static constexpr size_type NUM_KEYS_PER_LEAF = compute_num_keys_per_leaf();
+    ///> the number of children per `INode`
+    static constexpr size_type NUM_CHILDREN_PER_INODE = compute_num_children_per_inode();
+    ///> the number of messages buffered per `INode`
+    static constexpr size_type NUM_MESSAGES_PER_INODE = BUFFER_SIZE_IN_BYTES / sizeof(message);
+    static_assert(NUM_KEYS_PER_LEAF >= 2, "node size too small to split leaves");
+    static_assert(NUM_CHILDREN_PER_INODE >= 3, "node size too small to split inner nodes");
+
+    private:
+    struct Leaf : Node
+    {
+        std::array<key_type, NUM_KEYS_PER_LEAF> keys;
+        std::array<mapped_type, NUM_KEYS_PER_LEAF> values;
+
+        Leaf() : Node{ true, 0 } { }
+    };
+    static_assert(sizeof(Leaf) <= NODE_SIZE_IN_BYTES, "Leaf exceeds its size limit");
+
+    /** Child `children[i]` holds all keys `k` with `pivots[i-1] <= k < pivots[i]`.  The buffered messages are sorted by
+     * key and there is at most one message per key. */
+    struct INode : Node
+    {
+        size_type num_messages = 0;
+        std::array<key_type, NUM_CHILDREN_PER_INODE - 1> pivots;
+        std::array<Node*, NUM_CHILDREN_PER_INODE> children;
+        std::array<message, NUM_MESSAGES_PER_INODE> messages;
+
+        INode() : Node{ false, 0 } { }
+
+        ~INode() {
+            for (size_type i = 0; i != this->size; ++i)
+                delete_node(children[i]);
+        }
+    };
+    static_assert(sizeof(INode) <= NODE_SIZE_IN_BYTES, "INode exceeds its size limit");
+
+    /** A node created by a split together with the smallest key it may hold. */
+    using split_type = std::pair<key_type, Node*>;
+
+    Node *root_;
+    size_type height_ = 0;
+    size_type num_flushes_ = 0;
+
+    public:
+    BufferedBTree() : root_(new Leaf()) { }
+    ~BufferedBTree() { delete_node(root_); }
+
+    BufferedBTree(const BufferedBTree&) = delete;
+    BufferedBTree & operator=(const BufferedBTree&) = delete;
+
+    ///> returns the number of inner/non-leaf levels, a.k.a. the height
+    size_type height() const { return height_; }
+    ///> returns the number of batches of messages pushed from a buffer to a child so far
+    size_type num_flushes() const { return num_flushes_; }
+
+    /** Inserts the pair (\p key, \p value), overwriting the value of an existing element with the same key. */
+    void insert(const key_type &key, const mapped_type &value) { put_(message{ key, value, false }); }
+
+    /** Erases the element with the given \p key, if any. */
+    void erase(const key_type &key) { put_(message{ key, mapped_type(), true }); }
+
+    /** Returns the value of the element with the given \p key, if any, and `std::nullopt` otherwise. */
+    std::optional<mapped_type> find(const key_type &key) const {
+        const Node *node = root_;
+        while (not node->leaf) {
+            const INode *inode = static_cast<const INode*>(node);
+            const message *msgs = inode->messages.data();
+            const message *msg = lower_bound_(msgs, msgs + inode->num_messages, key);
+            if (msg != msgs + inode->num_messages and msg->key == key)
+                return msg->erase ? std::nullopt : std::optional<mapped_type>(msg->value);
+            node = inode->children[child_index_(inode, key)];
+        }
+        const Leaf *leaf = static_cast<const Leaf*>(node);
+        const size_type i = binary_search::lower_bound(leaf->keys.data(), leaf->size, key);
+        if (i != leaf->size and leaf->keys[i] == key)
+            return leaf->values[i];
+        return std::nullopt;
+    }
+
+    /** Pushes all buffered messages down to the leaves. */
+    void flush_all() {
+        std::vector<split_type> splits;
+        flush_all_(root_, splits);
+        grow_root_(splits);
+    }
+
+    /** Calls `fn(key, value)` for all elements in key order.  Requires that no messages are buffered, e.g. after
+     * `flush_all()`. */
+    template<typename Fn>
+    void for_each(Fn &&fn) const { for_each_(root_, fn); }
+
+    private:
+    static void delete_node(Node *node) {
+        if (node->leaf)
+            delete static_cast<Leaf*>(node);
+        else
+            delete static_cast<INode*>(node);
+    }
+
+    /** Returns the index of the child of \p inode responsible for \p key. */
+    static size_type child_index_(const INode *inode, const key_type &key) {
+        return binary_search::upper_bound(inode->pivots.data(), inode->size - 1, key);
+    }
+
+    void put_(message msg) {
+        std::vector<split_type> splits;
+        apply_(root_, &msg, 1, splits);
+        grow_root_(splits);
+    }
+
+    /** Makes the root and the nodes split off from it the children of a new root, until the root is not split
+     * anymore. */
+    void grow_root_(std::vector<split_type> &splits) {
+        while (not splits.empty()) {
+            INode *root = new INode();
+            root->children[0] = root_;
+            root->size = 1;
+            std::vector<split_type> root_splits;
+            insert_children_(root, splits, root_splits);
+            root_ = root;
+            ++height_;
+            splits = std::move(root_splits);
+        }
+    }
+
+    /** Applies the \p n messages at \p msgs, sorted by key and with at most one message per key, to the subtree rooted
+     * at \p node.  Nodes split off from \p node are appended to \p splits. */
+    void apply_(Node *node, const message *msgs, size_type n, std::vector<split_type> &splits) {
+        if (node->leaf)
+            apply_to_leaf_(static_cast<Leaf*>(node), msgs, n, splits);
+        else
+            apply_to_inode_(static_cast<INode*>(node), msgs, n, splits);
+    }
+
+    void apply_to_leaf_(Leaf *leaf, const message *msgs, size_type n, std::vector<split_type> &splits) {
+        if (n == 1) {
+            /* Fast path: apply a single message in place, unless it requires a split. */
+            const size_type i = binary_search::lower_bound(leaf->keys.data(), leaf->size, msgs->key);
+            const bool exists = i != leaf->size and leaf->keys[i] == msgs->key;
+            if (exists and msgs->erase) {
+                std::move(leaf->keys.begin() + i + 1, leaf->keys.begin() + leaf->size, leaf->keys.begin() + i);
+                std::move(leaf->values.begin() + i + 1, leaf->values.begin() + leaf->size, leaf->values.begin() + i);
+                --leaf->size;
+                return;
+            }
+            if (exists or msgs->erase) {
+                if (exists) leaf->values[i] = msgs->value;
+                return;
+            }
+            if (leaf->size < NUM_KEYS_PER_LEAF) {
+                std::move_backward(leaf->keys.begin() + i, leaf->keys.begin() + leaf->size,
+                                   leaf->keys.begin() + leaf->size + 1);
+                std::move_backward(leaf->values.begin() + i, leaf->values.begin() + leaf->size,
+                                   leaf->values.begin() + leaf->size + 1);
+                leaf->keys[i] = msgs->key;
+                leaf->values[i] = msgs->value;
+                ++leaf->size;
+                return;
+            }
+        }
+
+        /* Merge the entries of the leaf with the messages. */
+        std::vector<std::pair<key_type, mapped_type>> entries;
+        entries.reserve(leaf->size + n);
+        size_type i = 0;
+        for (const message *msg = msgs; msg != msgs + n; ++msg) {
+            for (; i != leaf->size and leaf->keys[i] < msg->key; ++i)
+                entries.emplace_back(leaf->keys[i], leaf->values[i]);
+            if (i != leaf->size and leaf->keys[i] == msg->key) ++i; // message supersedes the existing entry
+            if (not msg->erase)
+                entries.emplace_back(msg->key, msg->value);
+        }
+        for (; i != leaf->size; ++i)
+            entries.emplace_back(leaf->keys[i], leaf->values[i]);
+
+        /* Distribute the entries evenly over as many leaves as necessary. */
+        const size_type num_leaves =
+            std::max<size_type>(1, (entries.size() + NUM_KEYS_PER_LEAF - 1) / NUM_KEYS_PER_LEAF);
+        for (size_type l = 0; l != num_leaves; ++l) {
+            const size_type begin = l * entries.size() / num_leaves;
+            const size_type end = (l + 1) * entries.size() / num_leaves;
+            Leaf *target = l == 0 ? leaf : new Leaf();
+            target->size = end - begin;
+            for (size_type j = begin; j != end; ++j) {
+                target->keys[j - begin] = std::move(entries[j].first);
+                target->values[j - begin] = std::move(entries[j].second);
+            }
+            if (l != 0)
+                splits.emplace_back(target->keys[0], target);
+        }
+    }
+
+    void apply_to_inode_(INode *inode, const message *msgs, size_type n, std::vector<split_type> &splits) {
+        if (n == 1) {
+            /* Fast path: buffer a single message in place, if it fits. */
+            message *begin = inode->messages.data(), *end = begin + inode->num_messages;
+            message *pos = lower_bound_(begin, end, msgs->key);
+            if (pos != end and pos->key == msgs->key) {
+                *pos = *msgs;
+                return;
+            }
+            if (inode->num_messages < NUM_MESSAGES_PER_INODE) {
+                std::move_backward(pos, end, end + 1);
+                *pos = *msgs;
+                ++inode->num_messages;
+                return;
+            }
+            if constexpr (NUM_MESSAGES_PER_INODE == 0) {
+                /* Unbuffered: pass the message on to the child right away. */
+                const size_type c = child_index_(inode, msgs->key);
+                std::vector<split_type> child_splits;
+                apply_(inode->children[c], msgs, 1, child_splits);
+                if (not child_splits.empty())
+                    insert_children_(inode, child_splits, splits, c);
+                return;
+            }
+        }
+
+        /* Merge the buffered messages with the new ones; newer messages supersede older ones for the same key. */
+        std::vector<message> merged;
+        merged.reserve(inode->num_messages + n);
+        const message *old_msg = inode->messages.data(), *old_end = old_msg + inode->num_messages;
+        for (const message *msg = msgs; msg != msgs + n; ++msg) {
+            for (; old_msg != old_end and old_msg->key < msg->key; ++old_msg)
+                merged.push_back(std::move(*old_msg));
+            if (old_msg != old_end and old_msg->key == msg->key) ++old_msg;
+            merged.push_back(*msg);
+        }
+        for (; old_msg != old_end; ++old_msg)
+            merged.push_back(std::move(*old_msg));
+
+        /* While the buffer overflows, push the messages for the child with the most messages down in a batch. */
+        std::vector<split_type> child_splits;
+        while (merged.size() > NUM_MESSAGES_PER_INODE) {
+            size_type best_begin = 0, best_end = 0;
+            for (size_type begin = 0; begin != merged.size(); ) {
+                const size_type c = child_index_(inode, merged[begin].key);
+                size_type end = begin + 1;
+                while (end != merged.size() and child_index_(inode, merged[end].key) == c)
+                    ++end;
+                if (end - begin > best_end - best_begin)
+                    best_begin = begin, best_end = end;
+                begin = end;
+            }
+
+            const size_type c = child_index_(inode, merged[best_begin].key);
+            apply_(inode->children[c], merged.data() + best_begin, best_end - best_begin, child_splits);
+            merged.erase(merged.begin() + best_begin, merged.begin() + best_end);
+            ++num_flushes_;
+
+            /* Adopt the nodes split off from the child. */
+            if (not child_splits.empty()) {
+                std::vector<split_type> own_splits;
+                insert_children_(inode, child_splits, own_splits, c);
+                child_splits.clear();
+                if (not own_splits.empty()) {
+                    /* This node was split: apply the remaining messages to the nodes they belong to, which may split
+                     * these nodes further. */
+                    auto begin = merged.cbegin();
+                    for (size_type s = 0; s <= own_splits.size(); ++s) {
+                        auto end = s == own_splits.size() ? merged.cend() : lower_bound_(begin, merged.cend(),
+                                                                                          own_splits[s].first);
+                        INode *target = s == 0 ? inode : static_cast<INode*>(own_splits[s - 1].second);
+                        if (s != 0) splits.push_back(own_splits[s - 1]);
+                        target->num_messages = 0;
+                        apply_to_inode_(target, merged.data() + (begin - merged.cbegin()), end - begin, splits);
+                        begin = end;
+                    }
+                    return;
+                }
+            }
+        }
+        if constexpr (NUM_MESSAGES_PER_INODE != 0)
+            std::move(merged.begin(), merged.end(), inode->messages.begin());
+        inode->num_messages = merged.size();
+    }
+
+    /** Inserts the \p new_children, which were split off from child \p after of \p inode, into \p inode right after
+     * that child.  If \p inode overflows, it is split and the nodes split off are appended to \p splits. */
+    static void insert_children_(INode *inode, const std::vector<split_type> &new_children,
+                                 std::vector<split_type> &splits, size_type after = 0)
+    {
+        std::vector<key_type> pivots(inode->pivots.begin(), inode->pivots.begin() + inode->size - 1);
+        std::vector<Node*> children(inode->children.begin(), inode->children.begin() + inode->size);
+        for (size_type i = 0; i != new_children.size(); ++i) {
+            pivots.insert(pivots.begin() + after + i, new_children[i].first);
+            children.insert(children.begin() + after + 1 + i, new_children[i].second);
+        }
+        set_children_(inode, pivots, children, splits);
+    }
+
+    /** Makes \p children, separated by \p pivots, the children of \p inode.  If they do not fit, they are distributed
+     * evenly over \p inode and as many new inner nodes as necessary, which are appended to \p splits. */
+    static void set_children_(INode *inode, const std::vector<key_type> &pivots, const std::vector<Node*> &children,
+                              std::vector<split_type> &splits)
+    {
+        const size_type num_nodes = (children.size() + NUM_CHILDREN_PER_INODE - 1) / NUM_CHILDREN_PER_INODE;
+        for (size_type n = 0; n != num_nodes; ++n) {
+            const size_type begin = n * children.size() / num_nodes;
+            const size_type end = (n + 1) * children.size() / num_nodes;
+            INode *target = n == 0 ? inode : new INode();
+            target->size = end - begin;
+            std::copy(children.begin() + begin, children.begin() + end, target->children.begin());
+            std::copy(pivots.begin() + begin, pivots.begin() + end - 1, target->pivots.begin());
+            if (n != 0)
+                splits.emplace_back(pivots[begin - 1], target);
+        }
+    }
+
+    /** Returns the first of the messages in `[begin, end)` with key not less than \p key. */
+    template<typename It>
+    static It lower_bound_(It begin, It end, const key_type &key) {
+        return std::lower_bound(begin, end, key, [](const message &m, const key_type &k) { return m.key < k; });
+    }
+
+    void flush_all_(Node *node, std::vector<split_type> &splits) {
+        if (node->leaf) return;
+        INode *inode = static_cast<INode*>(node);
+
+        /* Push the messages of this node down, as a batch per child, and flush the children recursively.  Collect the
+         * resulting children, including those split off, in key order. */
+        std::vector<message> msgs;
+        if constexpr (NUM_MESSAGES_PER_INODE != 0)
+            msgs.assign(inode->messages.begin(), inode->messages.begin() + inode->num_messages);
+        inode->num_messages = 0;
+        std::vector<key_type> pivots;
+        std::vector<Node*> children;
+        auto flush_child = [&](Node *child) {
+            std::vector<split_type> child_splits; // siblings split off by flushing do not buffer any messages
+            flush_all_(child, child_splits);
+            children.push_back(child);
+            for (auto &[pivot, sibling] : child_splits) {
+                pivots.push_back(pivot);
+                children.push_back(sibling);
+            }
+        };
+        auto begin = msgs.cbegin();
+        for (size_type c = 0; c != inode->size; ++c) {
+            auto end = c + 1 == inode->size ? msgs.cend() : lower_bound_(begin, msgs.cend(), inode->pivots[c]);
+            if (c != 0) pivots.push_back(inode->pivots[c - 1]);
+            std::vector<split_type> child_splits;
+            if (begin != end) {
+                apply_(inode->children[c], &*begin, end - begin, child_splits);
+                ++num_flushes_;
+            }
+            flush_child(inode->children[c]);
+            for (auto &[pivot, sibling] : child_splits) {
+                pivots.push_back(pivot);
+                flush_child(sibling);
+            }
+            begin = end;
+        }
+        set_children_(inode, pivots, children, splits);
+    }
+
+    template<typename Fn>
+    static void for_each_(const Node *node, Fn &fn) {
+        if (node->leaf) {
+            const Leaf *leaf = static_cast<const Leaf*>(node);
+            for (size_type i = 0; i != leaf->size; ++i)
+                fn(leaf->keys[i], leaf->values[i]);
+            return;
+        }
+        const INode *inode = static_cast<const INode*>(node);
+        for (size_type c = 0; c != inode->size; ++c)
+            for_each_(inode->children[c], fn);
+    }
+};
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "BTree.hpp"
+#include "index_hash.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/** Implements a static hash index over \tparam Key - \tparam Value pairs, with the point lookup interface of `BTree`
+ * (`find()` and `equal_range()`, but no range queries).  The bulkloaded pairs are kept in their input order in two
+ * arrays, such that the pairs with equal key are adjacent; the hash table maps every distinct key to its first pair.
+ *
+ * The hash table uses open addressing in the style of Swiss tables:  slots are organized in groups of `GROUP_SIZE`,
+ * and for every slot a control byte holds either `EMPTY` or a 7 bit fingerprint of the hash of the key in the slot.  A
+ * lookup probes the groups in triangular order, starting at the group selected by the hash, and compares the
+ * fingerprint with all control bytes of a group at once (using SSE2, if available).  Only slots with matching
+ * fingerprint are compared by key.  The probe sequence ends at the first group with an empty slot. */
+template<
+    typename Key,
+    std::movable Value,
+    typename Hash = index_hash<Key>
+>
+requires std::equality_comparable<Key> and std::copyable<Key>
+struct HashIndex
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    ///> the number of slots whose control bytes are compared at once
+    static constexpr size_type GROUP_SIZE = 16;
+    ///> the maximum ratio of occupied slots is `MAX_LOAD_FACTOR_NUM / MAX_LOAD_FACTOR_DEN`
+    static constexpr size_type MAX_LOAD_FACTOR_NUM = 7;
+    static constexpr size_type MAX_LOAD_FACTOR_DEN = 8;
+
+    private:
+    ///> the control byte of an empty slot; fingerprints have the most significant bit cleared
+    static constexpr uint8_t EMPTY = 0x80;
+
+    struct slot
+    {
+        key_type key;
+        size_type first; ///< the index of the first pair with `key`
+    };
+
+    template<bool IsConst>
+    struct the_iterator
+    {
+        friend struct HashIndex;
+
+        static constexpr bool is_const = IsConst;
+        using value_type = std::conditional_t<is_const, const mapped_type, mapped_type>;
+
+        private:
+        using index_type = std::conditional_t<is_const, const HashIndex, HashIndex>;
+
+        index_type *index_;
+        size_type idx_;
+
+        public:
+        template<bool C = is_const> requires C
+        the_iterator(the_iterator<false> other) : index_(other.index_), idx_(other.idx_) { }
+        the_iterator(index_type *index, size_type idx) : index_(index), idx_(idx) { }
+
+        bool operator==(the_iterator other) const { return index_ == other.index_ and idx_ == other.idx_; }
+        bool operator!=(the_iterator other) const { return not operator==(other); }
+
+        the_iterator & operator++() { ++idx_; return *this; }
+
+        the_iterator operator++(int) {
+            the_iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        ref_pair<const key_type, value_type> operator*() const {
+            return ref_pair<const key_type, value_type>(index_->keys_[idx_], index_->values_[idx_]);
+        }
+    };
+
+    template<bool IsConst>
+    struct the_range
+    {
+        static constexpr bool is_const = IsConst;
+        using iter_t = the_iterator<is_const>;
+        private:
+        iter_t begin_, end_;
+
+        public:
+        the_range(iter_t begin, iter_t end) : begin_(begin), end_(end) { }
+
+        bool empty() const { return begin() == end(); }
+
+        iter_t begin() const { return begin_; }
+        iter_t end() const { return end_; }
+    };
+
+    public:
+    using iterator = the_iterator<false>;
+    using const_iterator = the_iterator<true>;
+
+    using range = the_range<false>;
+    using const_range = the_range<true>;
+
+    private:
+    std::vector<key_type> keys_;
+    std::vector<mapped_type> values_;
+    size_type num_groups_ = 0; ///< a power of 2
+    std::unique_ptr<uint8_t[]> control_; ///< `num_groups_ * GROUP_SIZE` control bytes
+    std::unique_ptr<slot[]> slots_;
+    [[no_unique_address]] Hash hash_;
+
+    public:
+    /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive), in which pairs with equal key must
+     * be adjacent (e.g. because the data is sorted by key, as for `BTree::Bulkload()`), into a fresh `HashIndex` and
+     * returns it. */
+    template<typename It>
+    static HashIndex Bulkload(It begin, It end)
+    requires requires (It it) {
+        key_type(std::move(it->first));
+        mapped_type(std::move(it->second));
+    }
+    {
+        HashIndex index;
+        for (It it = begin; it != end; ++it) {
+            index.keys_.emplace_back(std::move(it->first));
+            index.values_.emplace_back(std::move(it->second));
+        }
+
+        size_type num_distinct = 0;
+        for (size_type i = 0; i != index.keys_.size(); ++i)
+            num_distinct += i == 0 or not (index.keys_[i - 1] == index.keys_[i]);
+
+        /* Allocate enough groups to stay below the maximum load factor, and at least one empty slot. */
+        const size_type min_slots = num_distinct * MAX_LOAD_FACTOR_DEN / MAX_LOAD_FACTOR_NUM + 1;
+        index.num_groups_ = std::bit_ceil((min_slots + GROUP_SIZE - 1) / GROUP_SIZE);
+        index.control_ = std::make_unique<uint8_t[]>(index.num_groups_ * GROUP_SIZE);
+        std::fill_n(index.control_.get(), index.num_groups_ * GROUP_SIZE, EMPTY);
+        index.slots_ = std::make_unique<slot[]>(index.num_groups_ * GROUP_SIZE);
+
+        for (size_type i = 0; i != index.keys_.size(); ++i) {
+            if (i != 0 and index.keys_[i - 1] == index.keys_[i]) continue;
+            index.insert_(index.keys_[i], i);
+        }
+        return index;
+    }
+
+    private:
+    HashIndex() = default;
+
+    public:
+    HashIndex(HashIndex&&) = default;
+    HashIndex & operator=(HashIndex&&) = default;
+
+    ///> returns the size of the index, i.e. the number of key-value pairs
+    size_type size() const { return keys_.size(); }
+    ///> returns the number of slots of the hash table
+    size_type capacity() const { return num_groups_ * GROUP_SIZE; }
+
+    /** Returns an `iterator` to the first key-value pair of the index, if any, and `end()` otherwise. */
+    iterator begin() { return iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    iterator end() { return iterator(this, size()); }
+    /** Returns an `const_iterator` to the first key-value pair of the index, if any, and `end()` otherwise. */
+    const_iterator begin() const { return const_iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator end() const { return const_iterator(this, size()); }
+    /** Returns an `const_iterator` to the first key-value pair of the index, if any, and `end()` otherwise. */
+    const_iterator cbegin() const { return begin(); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator cend() const { return end(); }
+
+    /** Returns a `const_iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    const_iterator find(const key_type &key) const { return const_iterator(this, find_(key)); }
+    /** Returns an `iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    iterator find(const key_type &key) { return iterator(this, find_(key)); }
+
+    /** Returns a `const_range` of all elements with key equals to \p key. */
+    const_range equal_range(const key_type &key) const {
+        auto [begin, end] = equal_range_(key);
+        return const_range(const_iterator(this, begin), const_iterator(this, end));
+    }
+    /** Returns a `range` of all elements with key equals to \p key. */
+    range equal_range(const key_type &key) {
+        auto [begin, end] = equal_range_(key);
+        return range(iterator(this, begin), iterator(this, end));
+    }
+
+    private:
+    /** Returns the group where the probe sequence for \p hash starts. */
+    size_type home_group_(uint64_t hash) const { return (hash >> 7) & (num_groups_ - 1); }
+    /** Returns the fingerprint of \p hash stored in the control byte. */
+    static uint8_t fingerprint_(uint64_t hash) { return hash & 0x7f; }
+
+    /** Returns a bit mask of the slots of group \p group whose control byte equals \p byte. */
+    uint32_t match_(size_type group, uint8_t byte) const {
+        const uint8_t *control = control_.get() + group * GROUP_SIZE;
+#ifdef __SSE2__
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte)));
+#else
+        uint32_t mask = 0;
+        for (size_type i = 0; i != GROUP_SIZE; ++i)
+            mask |= uint32_t(control[i] == byte) << i;
+        return mask;
+#endif
+    }
+
+    void insert_(const key_type &key, size_type first) {
+        const uint64_t hash = hash_(key);
+        size_type group = home_group_(hash);
+        for (size_type step = 1; ; ++step) {
+            if (uint32_t empty = match_(group, EMPTY)) {
+                const size_type idx = group * GROUP_SIZE + std::countr_zero(empty);
+                control_[idx] = fingerprint_(hash);
+                slots_[idx] = slot{ key, first };
+                return;
+            }
+            group = (group + step) & (num_groups_ - 1); // triangular probing visits every group
+        }
+    }
+
+    /** Returns the index of the first pair with the given \p key, if any, and `size()` otherwise. */
+    size_type find_(const key_type &key) const {
+        if (num_groups_ == 0) return size();
+        const uint64_t hash = hash_(key);
+        const uint8_t fingerprint = fingerprint_(hash);
+        size_type group = home_group_(hash);
+        for (size_type step = 1; ; ++step) {
+            for (uint32_t candidates = match_(group, fingerprint); candidates; candidates &= candidates - 1) {
+                const slot &s = slots_[group * GROUP_SIZE + std::countr_zero(candidates)];
+                if (s.key == key) return s.first;
+            }
+            if (match_(group, EMPTY)) return size();
+            group = (group + step) & (num_groups_ - 1);
+        }
+    }
+
+    std::pair<size_type, size_type> equal_range_(const key_type &key) const {
+        const size_type begin = find_(key);
+        size_type end = begin;
+        while (end != size() and keys_[end] == key)
+            ++end;
+        return { begin, end };
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "index_hash.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+
+/** Implements a small direct-mapped cache of the results of point lookups into a \tparam Tree, e.g. a `BTree`, to
+ * answer lookups of hot keys without descending the tree.  The cache has \tparam NumEntries entries, each mapping a
+ * key to the `const_iterator` returned by `Tree::find()`, i.e. its leaf and position within the leaf, or to `cend()`
+ * for keys not in the tree.  A key is cached in the entry selected by its hash, replacing the previous key of that
+ * entry.  Entries are aligned such that none straddles a cache line.  The cache does not observe modifications of the
+ * tree; it must be `clear()`ed when the tree is modified. */
+template<typename Tree, std::size_t NumEntries = 1024>
+requires (std::has_single_bit(NumEntries))
+struct LookupCache
+{
+    using tree_type = Tree;
+    using key_type = typename tree_type::key_type;
+    using const_iterator = typename tree_type::const_iterator;
+    using size_type = std::size_t;
+
+    ///> the number of entries of the cache
+    static constexpr size_type NUM_ENTRIES = NumEntries;
+
+    private:
+    struct entry_data
+    {
+        key_type key;
+        const_iterator it;
+        bool valid;
+    };
+    static constexpr size_type CACHE_LINE_SIZE = 64;
+
+    struct alignas(std::min(CACHE_LINE_SIZE, std::bit_ceil(sizeof(entry_data)))) entry : entry_data { };
+
+    const tree_type &tree_;
+    std::vector<entry> entries_;
+    size_type num_hits_ = 0;
+    size_type num_misses_ = 0;
+
+    public:
+    explicit LookupCache(const tree_type &tree)
+        : tree_(tree)
+        , entries_(NUM_ENTRIES, entry{ { key_type(), tree.cend(), false } })
+    { }
+
+    ///> returns the number of lookups answered by the cache
+    size_type num_hits() const { return num_hits_; }
+    ///> returns the number of lookups that descended the tree
+    size_type num_misses() const { return num_misses_; }
+
+    /** Returns a `const_iterator` to the first element with the given \p key, if any, and `end()` of the tree
+     * otherwise, as `Tree::find()`. */
+    const_iterator find(const key_type &key) {
+        entry &e = entries_[index_hash<key_type>{}(key) & (NUM_ENTRIES - 1)];
+        if (e.valid and e.key == key) {
+            ++num_hits_;
+            return e.it;
+        }
+        ++num_misses_;
+        e = entry{ { key, tree_.find(key), true } };
+        return e.it;
+    }
+
+    /** Invalidates all entries and resets the counters. */
+    void clear() {
+        std::fill(entries_.begin(), entries_.end(), entry{ { key_type(), tree_.cend(), false } });
+        num_hits_ = num_misses_ = 0;
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "numa.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/** Keeps one replica of a read-only, bulkloaded \tparam Index, e.g. a `BTree`, per NUMA node, such that lookups from
+ * any node read node-local memory only.  Each replica is bulkloaded by a thread that is pinned to the CPUs of the
+ * replica's node and whose memory policy is bound to that node; hence all nodes of the replica are allocated (and
+ * first touched) on that node.  Threads obtain the replica of the node they run on with `local()`; threads that
+ * should keep using the same replica must be pinned to a node, e.g. with `numa::pin_thread_to_node()`.  On a machine
+ * with a single node, there is a single replica. */
+template<typename Index>
+struct ReplicatedIndex
+{
+    using index_type = Index;
+    using size_type = std::size_t;
+
+    private:
+    const numa::topology *topology_;
+    std::vector<std::unique_ptr<const index_type>> replicas_; ///< one replica per node, in the order of the topology
+
+    ReplicatedIndex(const numa::topology &topology) : topology_(&topology), replicas_(topology.num_nodes()) { }
+
+    public:
+    /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive) into one fresh replica of `Index`
+     * per NUMA node of \p topology, using `Index::Bulkload()`, and returns the replicated index.  The replicas are
+     * bulkloaded concurrently. */
+    template<typename It>
+    static ReplicatedIndex Bulkload(It begin, It end, const numa::topology &topology = numa::topology::Get()) {
+        ReplicatedIndex replicated(topology);
+        std::vector<std::thread> threads;
+        for (size_type node = 0; node != topology.num_nodes(); ++node) {
+            threads.emplace_back([&replicated, &topology, node, begin, end]() {
+                numa::pin_thread_to_node(topology, node);
+                const bool bound = numa::bind_memory_to_node(topology.nodes[node]);
+                /* Construct the replica in place, since `Index` need not be movable. */
+                replicated.replicas_[node].reset(new index_type(index_type::Bulkload(begin, end)));
+                if (bound) numa::reset_memory_policy();
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+        return replicated;
+    }
+
+    ///> returns the number of replicas, i.e. the number of NUMA nodes
+    size_type num_replicas() const { return replicas_.size(); }
+
+    /** Returns the replica on the node with index \p node in the topology. */
+    const index_type & replica(size_type node) const { return *replicas_[node]; }
+
+    /** Returns the replica on the node the calling thread currently runs on. */
+    const index_type & local() const { return *replicas_[topology_->current_node()]; }
+};
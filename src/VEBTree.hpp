@@ -0,0 +1,285 @@
+#pragma once
+
+#include "BTree.hpp"
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/** Implements a static, cache-oblivious search tree over \tparam Key - \tparam Value pairs, with the same lookup
+ * interface as `BTree`.  The bulkloaded pairs are kept in key order in two arrays.  The first key of every run of equal
+ * keys is placed in a complete binary search tree, which is stored in van Emde Boas order:  a tree of height `h` is
+ * split into a top tree of height `h/2` and the bottom trees hanging off its leaves; the top tree is stored first,
+ * followed by the bottom trees, all laid out recursively.  Hence, a root-to-leaf path of length `h` touches only
+ * `O(log_B(N))` blocks of size `B` for *every* `B` at once, i.e. at the granularity of cache lines, pages, and TLB
+ * reach, without a tuning parameter such as the node size of a `BTree`.
+ *
+ * The position of a node in the van Emde Boas order is computed during the search from its position in breadth-first
+ * order, following Brodal, Fagerberg, and Jacob, "Cache Oblivious Search Trees via Binary Trees of Small Height", SODA
+ * 2002. */
+template<
+    typename Key,
+    std::movable Value
+>
+requires sortable<Key> and std::copyable<Key>
+struct VEBTree
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    ///> the maximum height of the binary search tree
+    static constexpr size_type MAX_HEIGHT = 64;
+
+    private:
+    /** For every depth `d > 0` of the tree, the recursive decomposition separates depth `d - 1` and `d` exactly once,
+     * namely when splitting the subtree whose root is at depth `top_depth[d]` into a top tree of size `top_size[d]`
+     * and bottom trees of size `bottom_size[d]` each, rooted at depth `d`. */
+    struct level
+    {
+        size_type top_size;
+        size_type bottom_size;
+        size_type top_depth;
+    };
+
+    template<bool IsConst>
+    struct the_iterator
+    {
+        friend struct VEBTree;
+
+        static constexpr bool is_const = IsConst;
+        using value_type = std::conditional_t<is_const, const mapped_type, mapped_type>;
+
+        private:
+        using tree_type = std::conditional_t<is_const, const VEBTree, VEBTree>;
+
+        tree_type *tree_;
+        size_type idx_;
+
+        public:
+        template<bool C = is_const> requires C
+        the_iterator(the_iterator<false> other) : tree_(other.tree_), idx_(other.idx_) { }
+        the_iterator(tree_type *tree, size_type idx) : tree_(tree), idx_(idx) { }
+
+        bool operator==(the_iterator other) const { return tree_ == other.tree_ and idx_ == other.idx_; }
+        bool operator!=(the_iterator other) const { return not operator==(other); }
+
+        the_iterator & operator++() { ++idx_; return *this; }
+
+        the_iterator operator++(int) {
+            the_iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        ref_pair<const key_type, value_type> operator*() const {
+            return ref_pair<const key_type, value_type>(tree_->keys_[idx_], tree_->values_[idx_]);
+        }
+    };
+
+    template<bool IsConst>
+    struct the_range
+    {
+        static constexpr bool is_const = IsConst;
+        using iter_t = the_iterator<is_const>;
+        private:
+        iter_t begin_, end_;
+
+        public:
+        the_range(iter_t begin, iter_t end) : begin_(begin), end_(end) { }
+
+        bool empty() const { return begin() == end(); }
+
+        iter_t begin() const { return begin_; }
+        iter_t end() const { return end_; }
+    };
+
+    public:
+    using iterator = the_iterator<false>;
+    using const_iterator = the_iterator<true>;
+
+    using range = the_range<false>;
+    using const_range = the_range<true>;
+
+    private:
+    std::vector<key_type> keys_;
+    std::vector<mapped_type> values_;
+    size_type height_ = 0;
+    std::array<level, MAX_HEIGHT> levels_;
+    std::vector<key_type> tree_keys_; ///< the keys of the search tree in van Emde Boas order
+    std::vector<size_type> tree_firsts_; ///< for every key of the search tree, the index of its first pair
+
+    public:
+    /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive), which must be sorted by key, into
+     * a fresh `VEBTree` and returns it. */
+    template<typename It>
+    static VEBTree Bulkload(It begin, It end)
+    requires requires (It it) {
+        key_type(std::move(it->first));
+        mapped_type(std::move(it->second));
+    }
+    {
+        VEBTree tree;
+        for (It it = begin; it != end; ++it) {
+            tree.keys_.emplace_back(std::move(it->first));
+            tree.values_.emplace_back(std::move(it->second));
+        }
+
+        std::vector<size_type> firsts;
+        for (size_type i = 0; i != tree.keys_.size(); ++i)
+            if (i == 0 or not (tree.keys_[i - 1] == tree.keys_[i]))
+                firsts.push_back(i);
+        if (firsts.empty()) return tree;
+
+        /* Build a complete tree.  Pad the keys with copies of the largest key that refer to the end. */
+        tree.height_ = std::bit_width(firsts.size());
+        tree.compute_levels_(0, tree.height_);
+        const size_type num_nodes = (size_type(1) << tree.height_) - 1;
+        tree.tree_keys_.resize(num_nodes, tree.keys_.back());
+        tree.tree_firsts_.resize(num_nodes, tree.size());
+
+        /* Assign the keys in in-order to the nodes. */
+        std::array<size_type, MAX_HEIGHT> pos;
+        pos[0] = 0;
+        size_type next = 0;
+        tree.build_(firsts, 1, 0, pos, next);
+        return tree;
+    }
+
+    private:
+    VEBTree() = default;
+
+    public:
+    VEBTree(VEBTree&&) = default;
+    VEBTree & operator=(VEBTree&&) = default;
+
+    ///> returns the size of the tree, i.e. the number of key-value pairs
+    size_type size() const { return keys_.size(); }
+    ///> returns the height of the binary search tree
+    size_type height() const { return height_; }
+
+    /** Returns an `iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    iterator begin() { return iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    iterator end() { return iterator(this, size()); }
+    /** Returns an `const_iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    const_iterator begin() const { return const_iterator(this, 0); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator end() const { return const_iterator(this, size()); }
+    /** Returns an `const_iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
+    const_iterator cbegin() const { return begin(); }
+    /** Returns the past-the-end `iterator`. */
+    const_iterator cend() const { return end(); }
+
+    /** Returns a `const_iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    const_iterator find(const key_type &key) const { return const_iterator(this, find_(key)); }
+    /** Returns an `iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
+    iterator find(const key_type &key) { return iterator(this, find_(key)); }
+
+    /** Returns a `const_range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi`
+     * excluding. */
+    const_range find_range(const key_type &lo, const key_type &hi) const {
+        auto [begin, end] = find_range_(lo, hi);
+        return const_range(const_iterator(this, begin), const_iterator(this, end));
+    }
+    /** Returns a `range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi` excluding.
+     * */
+    range find_range(const key_type &lo, const key_type &hi) {
+        auto [begin, end] = find_range_(lo, hi);
+        return range(iterator(this, begin), iterator(this, end));
+    }
+
+    /** Returns a `const_range` of all elements with key equals to \p key. */
+    const_range equal_range(const key_type &key) const {
+        auto [begin, end] = equal_range_(key);
+        return const_range(const_iterator(this, begin), const_iterator(this, end));
+    }
+    /** Returns a `range` of all elements with key equals to \p key. */
+    range equal_range(const key_type &key) {
+        auto [begin, end] = equal_range_(key);
+        return range(iterator(this, begin), iterator(this, end));
+    }
+
+    private:
+    /** Computes the `levels_` for the subtree of height \p height rooted at depth \p depth. */
+    void compute_levels_(size_type depth, size_type height) {
+        if (height <= 1) return;
+        const size_type top_height = height / 2;
+        const size_type bottom_height = height - top_height;
+        levels_[depth + top_height] = level{
+            .top_size = (size_type(1) << top_height) - 1,
+            .bottom_size = (size_type(1) << bottom_height) - 1,
+            .top_depth = depth,
+        };
+        compute_levels_(depth, top_height);
+        compute_levels_(depth + top_height, bottom_height);
+    }
+
+    /** Returns the position in van Emde Boas order of the node at \p depth > 0 with breadth-first index \p bfs (the
+     * root has index 1), given the positions \p pos of its ancestors. */
+    size_type position_(size_type bfs, size_type depth, const std::array<size_type, MAX_HEIGHT> &pos) const {
+        const level &l = levels_[depth];
+        return pos[l.top_depth] + l.top_size + (bfs & l.top_size) * l.bottom_size;
+    }
+
+    /** Assigns the keys in in-order to the subtree whose root has breadth-first index \p bfs, is located at depth \p
+     * depth, and is stored at position `pos[depth]`. */
+    void build_(const std::vector<size_type> &firsts, size_type bfs, size_type depth,
+                std::array<size_type, MAX_HEIGHT> &pos, size_type &next)
+    {
+        if (depth + 1 != height_) {
+            pos[depth + 1] = position_(2 * bfs, depth + 1, pos);
+            build_(firsts, 2 * bfs, depth + 1, pos, next);
+        }
+        if (next != firsts.size()) {
+            tree_keys_[pos[depth]] = keys_[firsts[next]];
+            tree_firsts_[pos[depth]] = firsts[next];
+            ++next;
+        }
+        if (depth + 1 != height_) {
+            pos[depth + 1] = position_(2 * bfs + 1, depth + 1, pos);
+            build_(firsts, 2 * bfs + 1, depth + 1, pos, next);
+        }
+    }
+
+    /** Returns the index of the first pair with key not less than \p key, if any, and `size()` otherwise. */
+    size_type lower_bound_(const key_type &key) const {
+        if (height_ == 0) return size();
+        std::array<size_type, MAX_HEIGHT> pos;
+        pos[0] = 0;
+        size_type candidate = tree_keys_.size(); // the position of the smallest key not less than `key` seen so far
+        size_type bfs = 1;
+        for (size_type depth = 0; ; ) {
+            const size_type p = pos[depth];
+            const bool right = tree_keys_[p] < key;
+            if (not right) candidate = p;
+            if (++depth == height_) break;
+            bfs = 2 * bfs + right;
+            pos[depth] = position_(bfs, depth, pos);
+        }
+        return candidate == tree_keys_.size() ? size() : tree_firsts_[candidate];
+    }
+
+    /** Returns the index of the first pair with the given \p key, if any, and `size()` otherwise. */
+    size_type find_(const key_type &key) const {
+        const size_type idx = lower_bound_(key);
+        return idx != size() and keys_[idx] == key ? idx : size();
+    }
+
+    std::pair<size_type, size_type> find_range_(const key_type &lo, const key_type &hi) const {
+        if (not (lo < hi)) return { size(), size() };
+        return { lower_bound_(lo), lower_bound_(hi) };
+    }
+
+    std::pair<size_type, size_type> equal_range_(const key_type &key) const {
+        const size_type begin = find_(key);
+        size_type end = begin;
+        while (end != size() and keys_[end] == key)
+            ++end;
+        return { begin, end };
+    }
+};
@@ -0,0 +1,398 @@
+#pragma once
+
+#include "BTree.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+/** Implements a multi-version B+-tree of \tparam Key - \tparam Value pairs with copy-on-write updates.  Nodes are
+ * immutable once published and shared between versions by reference counting.  An update copies the path from the
+ * root to the affected leaf and publishes the new root atomically, so readers can pin a `snapshot` and read it without
+ * any locking while a writer keeps publishing new versions.  Writers are serialized internally.  The size of tree
+ * nodes is approximated by \tparam NodeSizeInBytes, which determines the fan-out. */
+template<
+    typename Key,
+    std::copyable Value,
+    std::size_t NodeSizeInBytes
+>
+requires sortable<Key> and std::copyable<Key>
+struct VersionedBTree
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    ///> the (approximate) size of tree nodes (both `INode` and `Leaf`)
+    static constexpr size_type NODE_SIZE_IN_BYTES = NodeSizeInBytes;
+
+    private:
+    struct Node
+    {
+        bool leaf;
+        size_type size; ///< number of entries of a `Leaf`, number of children of an `INode`
+    };
+    using node_ptr = std::shared_ptr<const Node>;
+
+    static constexpr size_type compute_num_keys_per_leaf() {
+        return (NODE_SIZE_IN_BYTES - sizeof(Node)) / (sizeof(key_type) + sizeof(mapped_type));
+    }
+    static constexpr size_type compute_num_keys_per_inode() {
+        return (NODE_SIZE_IN_BYTES - sizeof(Node) - sizeof(node_ptr)) / (sizeof(key_type) + sizeof(node_ptr));
+    }
+
+    public:
+    ///> the number of key-value pairs per `Leaf`
+    static constexpr size_type NUM_KEYS_PER_LEAF = compute_num_keys_per_leaf();
+    ///> the number of keys per `INode`
+    static constexpr size_type NUM_KEYS_PER_INODE = compute_num_keys_per_inode();
+    static_assert(NUM_KEYS_PER_LEAF >= 2, "node size too small to split leaves");
+    static_assert(NUM_KEYS_PER_INODE >= 2, "node size too small to split inner nodes");
+
+    private:
+    struct Leaf : Node
+    {
+        std::array<key_type, NUM_KEYS_PER_LEAF> keys;
+        std::array<mapped_type, NUM_KEYS_PER_LEAF> values;
+
+        Leaf() : Node{ true, 0 } { }
+    };
+
+    /** `keys[i]` separates `children[i]` from `children[i+1]`: no key in `children[i]` is greater and no key in
+     * `children[i+1]` is smaller. */
+    struct INode : Node
+    {
+        std::array<key_type, NUM_KEYS_PER_INODE> keys;
+        std::array<node_ptr, NUM_KEYS_PER_INODE + 1> children;
+
+        INode() : Node{ false, 0 } { }
+    };
+
+    /** An immutable version of the tree. */
+    struct Version
+    {
+        node_ptr root;
+        size_type size;
+        size_type height;
+    };
+
+    public:
+    /** A pinned, immutable version of the tree.  A `snapshot` keeps all nodes of its version alive and stays valid and
+     * unchanged no matter which versions are published after it was taken. */
+    struct snapshot
+    {
+        friend struct VersionedBTree;
+
+        private:
+        std::shared_ptr<const Version> version_;
+
+        snapshot(std::shared_ptr<const Version> version) : version_(std::move(version)) { }
+
+        public:
+        ///> returns the number of key-value pairs in this version
+        size_type size() const { return version_->size; }
+        ///> returns the number of inner/non-leaf levels in this version
+        size_type height() const { return version_->height; }
+
+        /** Returns a pointer to the value of the first element with the given \p key, if any, and `nullptr` otherwise.
+         * The pointer remains valid as long as this `snapshot` is alive. */
+        const mapped_type * find(const key_type &key) const {
+            if (size() == 0) return nullptr;
+            auto [leaf, idx] = lower_bound_(version_->root.get(), key);
+            if (leaf == nullptr or not (leaf->keys[idx] == key)) return nullptr;
+            return &leaf->values[idx];
+        }
+
+        /** Calls `fn(key, value)` for all elements with key in the interval `[lo, hi)` in key order. */
+        template<typename Fn>
+        void scan(const key_type &lo, const key_type &hi, Fn &&fn) const {
+            if (size() == 0) return;
+            scan_(version_->root.get(), lo, hi, fn);
+        }
+    };
+
+    private:
+    std::atomic<std::shared_ptr<const Version>> current_;
+    std::mutex writer_mutex_;
+
+    public:
+    /** Creates an empty tree. */
+    VersionedBTree() : current_(make_version_(std::make_shared<Leaf>(), 0, 0)) { }
+
+    /** Creates a tree from the sorted data in the range from `begin` (inclusive) to `end` (exclusive). */
+    template<typename It>
+    VersionedBTree(It begin, It end) : current_(bulkload_(begin, end)) { }
+
+    VersionedBTree(const VersionedBTree&) = delete;
+    VersionedBTree & operator=(const VersionedBTree&) = delete;
+
+    /** Pins and returns the most recently published version. */
+    snapshot get_snapshot() const { return snapshot(current_.load(std::memory_order_acquire)); }
+
+    ///> returns the number of key-value pairs in the most recently published version
+    size_type size() const { return get_snapshot().size(); }
+    ///> returns the number of inner/non-leaf levels in the most recently published version
+    size_type height() const { return get_snapshot().height(); }
+
+    /** Replaces the contents of the tree by the sorted data in the range from `begin` (inclusive) to `end` (exclusive).
+     * The new version is built aside and published atomically. */
+    template<typename It>
+    void assign(It begin, It end) {
+        auto version = bulkload_(begin, end);
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        current_.store(std::move(version), std::memory_order_release);
+    }
+
+    /** Inserts the pair (\p key, \p value) after all elements with the same key and publishes the new version. */
+    void insert(const key_type &key, const mapped_type &value) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        auto current = current_.load(std::memory_order_relaxed);
+
+        auto [node, split] = insert_(current->root.get(), key, value);
+        size_type height = current->height;
+        if (split) {
+            /* The root was split, grow the tree by one level. */
+            auto root = std::make_shared<INode>();
+            root->size = 2;
+            root->keys[0] = split->first;
+            root->children[0] = std::move(node);
+            root->children[1] = std::move(split->second);
+            node = std::move(root);
+            ++height;
+        }
+        current_.store(make_version_(std::move(node), current->size + 1, height), std::memory_order_release);
+    }
+
+    /** Erases the first element with the given \p key, if any, and publishes the new version.  Returns `true` iff an
+     * element was erased.  Nodes are not rebalanced; a node is only removed once it becomes empty. */
+    bool erase(const key_type &key) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        auto current = current_.load(std::memory_order_relaxed);
+        if (current->size == 0) return false;
+
+        auto node = erase_(current->root.get(), key);
+        if (not node) return false;
+
+        size_type height = current->height;
+        if (*node == nullptr) {
+            /* The last element was erased. */
+            *node = std::make_shared<Leaf>();
+            height = 0;
+        }
+        /* Shrink the tree while the root has a single child. */
+        while (not (*node)->leaf and (*node)->size == 1) {
+            *node = static_cast<const INode*>(node->get())->children[0];
+            --height;
+        }
+        current_.store(make_version_(std::move(*node), current->size - 1, height), std::memory_order_release);
+        return true;
+    }
+
+    private:
+    static std::shared_ptr<const Version> make_version_(node_ptr root, size_type size, size_type height) {
+        return std::make_shared<const Version>(Version{ std::move(root), size, height });
+    }
+
+    template<typename It>
+    static std::shared_ptr<const Version> bulkload_(It begin, It end) {
+        size_type size = 0;
+        std::vector<std::pair<key_type, node_ptr>> children; // nodes of the current level with their smallest key
+        std::shared_ptr<Leaf> leaf;
+        for (It it = begin; it != end; ++it, ++size) {
+            if (not leaf or leaf->size == NUM_KEYS_PER_LEAF) {
+                leaf = std::make_shared<Leaf>();
+                children.emplace_back(it->first, leaf);
+            }
+            leaf->keys[leaf->size] = it->first;
+            leaf->values[leaf->size] = it->second;
+            ++leaf->size;
+        }
+        if (children.empty())
+            return make_version_(std::make_shared<Leaf>(), 0, 0);
+
+        size_type height = 0;
+        while (children.size() > 1) {
+            std::vector<std::pair<key_type, node_ptr>> parents;
+            std::shared_ptr<INode> inode;
+            for (auto &[key, child] : children) {
+                if (not inode or inode->size == NUM_KEYS_PER_INODE + 1) {
+                    inode = std::make_shared<INode>();
+                    parents.emplace_back(key, inode);
+                } else {
+                    inode->keys[inode->size - 1] = key;
+                }
+                inode->children[inode->size++] = std::move(child);
+            }
+            children = std::move(parents);
+            ++height;
+        }
+        return make_version_(std::move(children.front().second), size, height);
+    }
+
+    /** Returns the leaf and the index within that leaf of the first element with key not less than \p key in the
+     * subtree rooted at \p node, if any, and `nullptr` otherwise. */
+    static std::pair<const Leaf*, size_type> lower_bound_(const Node *node, const key_type &key) {
+        if (node->leaf) {
+            const Leaf *leaf = static_cast<const Leaf*>(node);
+            size_type i = 0;
+            while (i < leaf->size and leaf->keys[i] < key)
+                ++i;
+            return { i == leaf->size ? nullptr : leaf, i };
+        }
+        const INode *inode = static_cast<const INode*>(node);
+        for (size_type i = child_index_lower_(inode, key); i != inode->size; ++i) {
+            auto result = lower_bound_(inode->children[i].get(), key);
+            if (result.first) return result;
+        }
+        return { nullptr, 0 };
+    }
+
+    template<typename Fn>
+    static void scan_(const Node *node, const key_type &lo, const key_type &hi, Fn &fn) {
+        if (node->leaf) {
+            const Leaf *leaf = static_cast<const Leaf*>(node);
+            for (size_type i = 0; i != leaf->size; ++i) {
+                if (leaf->keys[i] < lo) continue;
+                if (not (leaf->keys[i] < hi)) break;
+                fn(leaf->keys[i], leaf->values[i]);
+            }
+            return;
+        }
+        const INode *inode = static_cast<const INode*>(node);
+        for (size_type i = child_index_lower_(inode, lo); i != inode->size; ++i) {
+            if (i != 0 and not (inode->keys[i - 1] < hi)) break;
+            scan_(inode->children[i].get(), lo, hi, fn);
+        }
+    }
+
+    /** Returns the index of the leftmost child of \p inode that may contain \p key. */
+    static size_type child_index_lower_(const INode *inode, const key_type &key) {
+        size_type i = 0;
+        while (i < inode->size - 1 and inode->keys[i] < key)
+            ++i;
+        return i;
+    }
+
+    /** Returns the index of the rightmost child of \p inode that may contain \p key. */
+    static size_type child_index_upper_(const INode *inode, const key_type &key) {
+        size_type i = 0;
+        while (i < inode->size - 1 and not (key < inode->keys[i]))
+            ++i;
+        return i;
+    }
+
+    /** Inserts (\p key, \p value) into a copy of the subtree rooted at \p node.  Returns the root of the copy and, if
+     * the copy had to be split, the smallest key and the root of the new right sibling. */
+    static std::pair<node_ptr, std::optional<std::pair<key_type, node_ptr>>>
+    insert_(const Node *node, const key_type &key, const mapped_type &value) {
+        if (node->leaf) {
+            auto leaf = std::make_shared<Leaf>(*static_cast<const Leaf*>(node));
+            size_type pos = 0;
+            while (pos < leaf->size and not (key < leaf->keys[pos]))
+                ++pos;
+
+            if (leaf->size < NUM_KEYS_PER_LEAF) {
+                insert_at_(leaf->keys, leaf->size, pos, key);
+                insert_at_(leaf->values, leaf->size, pos, value);
+                ++leaf->size;
+                return { std::move(leaf), std::nullopt };
+            }
+
+            /* Split the full leaf in halves and insert into the proper half. */
+            auto right = std::make_shared<Leaf>();
+            const size_type mid = NUM_KEYS_PER_LEAF / 2;
+            right->size = leaf->size - mid;
+            std::move(leaf->keys.begin() + mid, leaf->keys.begin() + leaf->size, right->keys.begin());
+            std::move(leaf->values.begin() + mid, leaf->values.begin() + leaf->size, right->values.begin());
+            leaf->size = mid;
+            Leaf *target = pos <= mid ? leaf.get() : right.get();
+            if (target == right.get()) pos -= mid;
+            insert_at_(target->keys, target->size, pos, key);
+            insert_at_(target->values, target->size, pos, value);
+            ++target->size;
+            key_type separator = right->keys[0];
+            return { std::move(leaf), std::make_pair(std::move(separator), std::move(right)) };
+        }
+
+        auto inode = std::make_shared<INode>(*static_cast<const INode*>(node));
+        const size_type idx = child_index_upper_(inode.get(), key);
+        auto [child, split] = insert_(inode->children[idx].get(), key, value);
+        inode->children[idx] = std::move(child);
+        if (not split)
+            return { std::move(inode), std::nullopt };
+
+        if (inode->size < NUM_KEYS_PER_INODE + 1) {
+            insert_at_(inode->keys, inode->size - 1, idx, std::move(split->first));
+            insert_at_(inode->children, inode->size, idx + 1, std::move(split->second));
+            ++inode->size;
+            return { std::move(inode), std::nullopt };
+        }
+
+        /* Split the full inner node: gather all separators and children, then distribute them over two nodes. */
+        std::vector<key_type> keys(inode->keys.begin(), inode->keys.begin() + inode->size - 1);
+        std::vector<node_ptr> children(inode->children.begin(), inode->children.begin() + inode->size);
+        keys.insert(keys.begin() + idx, std::move(split->first));
+        children.insert(children.begin() + idx + 1, std::move(split->second));
+
+        auto right = std::make_shared<INode>();
+        const size_type left_size = children.size() / 2;
+        inode->size = left_size;
+        right->size = children.size() - left_size;
+        std::move(keys.begin(), keys.begin() + left_size - 1, inode->keys.begin());
+        std::move(keys.begin() + left_size, keys.end(), right->keys.begin());
+        std::move(children.begin(), children.begin() + left_size, inode->children.begin());
+        std::move(children.begin() + left_size, children.end(), right->children.begin());
+        std::fill(inode->children.begin() + left_size, inode->children.end(), nullptr);
+        return { std::move(inode), std::make_pair(std::move(keys[left_size - 1]), std::move(right)) };
+    }
+
+    /** Erases the first element with the given \p key from a copy of the subtree rooted at \p node.  Returns
+     * `std::nullopt` if there is no such element, `nullptr` if the copy became empty, and the root of the copy
+     * otherwise. */
+    static std::optional<node_ptr> erase_(const Node *node, const key_type &key) {
+        if (node->leaf) {
+            const Leaf *old_leaf = static_cast<const Leaf*>(node);
+            size_type pos = 0;
+            while (pos < old_leaf->size and old_leaf->keys[pos] < key)
+                ++pos;
+            if (pos == old_leaf->size or not (old_leaf->keys[pos] == key)) return std::nullopt;
+            if (old_leaf->size == 1) return node_ptr();
+
+            auto leaf = std::make_shared<Leaf>(*old_leaf);
+            std::move(leaf->keys.begin() + pos + 1, leaf->keys.begin() + leaf->size, leaf->keys.begin() + pos);
+            std::move(leaf->values.begin() + pos + 1, leaf->values.begin() + leaf->size, leaf->values.begin() + pos);
+            --leaf->size;
+            return leaf;
+        }
+
+        const INode *old_inode = static_cast<const INode*>(node);
+        for (size_type i = child_index_lower_(old_inode, key); i != old_inode->size; ++i) {
+            if (i != 0 and key < old_inode->keys[i - 1]) break;
+            auto child = erase_(old_inode->children[i].get(), key);
+            if (not child) continue;
+
+            if (*child == nullptr and old_inode->size == 1) return node_ptr();
+            auto inode = std::make_shared<INode>(*old_inode);
+            if (*child) {
+                inode->children[i] = std::move(*child);
+            } else {
+                /* Remove the empty child together with one of its separators. */
+                const size_type k = i == 0 ? 0 : i - 1;
+                std::move(inode->keys.begin() + k + 1, inode->keys.begin() + inode->size - 1, inode->keys.begin() + k);
+                std::move(inode->children.begin() + i + 1, inode->children.begin() + inode->size,
+                          inode->children.begin() + i);
+                inode->children[--inode->size] = nullptr;
+            }
+            return inode;
+        }
+        return std::nullopt;
+    }
+
+    /** Inserts \p value at position \p pos into the first \p size elements of \p arr. */
+    template<typename T, std::size_t N, typename U>
+    static void insert_at_(std::array<T, N> &arr, size_type size, size_type pos, U &&value) {
+        std::move_backward(arr.begin() + pos, arr.begin() + size, arr.begin() + size + 1);
+        arr[pos] = std::forward<U>(value);
+    }
+};
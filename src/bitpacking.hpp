@@ -0,0 +1,205 @@
+#pragma once
+
+#include "mutable/util/macro.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+namespace detail {
+
+/** Packs the \p n values \p values as offsets to \p base of \p bits bits each into \p words, which must be zeroed. */
+inline void pack(const int32_t *values, std::size_t n, unsigned bits, int32_t base, uint64_t *words)
+{
+    if (bits == 0) return;
+    for (std::size_t i = 0; i != n; ++i) {
+        const uint64_t delta = uint32_t(values[i]) - uint32_t(base);
+        const uint64_t pos = i * bits;
+        const unsigned shift = pos % 64;
+        words[pos / 64] |= delta << shift;
+        if (shift + bits > 64)
+            words[pos / 64 + 1] |= delta >> (64 - shift);
+    }
+}
+
+/** Unpacks \p n values of \p bits bits each from \p words and adds \p base to every value.  Every value is read with a
+ * 64 bit load from the byte holding its first bit, hence \p words must be followed by a padding word.  Uses AVX2 to
+ * gather and shift four values at a time, if available. */
+inline void unpack(const uint64_t *words, std::size_t n, unsigned bits, int32_t base, int32_t *out)
+{
+    const char *bytes = reinterpret_cast<const char*>(words);
+    const uint64_t mask = (uint64_t(1) << bits) - 1;
+    std::size_t i = 0;
+#ifdef __AVX2__
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i vbits = _mm_set1_epi32(bits);
+    const __m128i vseven = _mm_set1_epi32(7);
+    const __m256i vmask = _mm256_set1_epi64x(mask);
+    const __m256i vpermute = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i vbase = _mm_set1_epi32(base);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i pos = _mm_mullo_epi32(_mm_add_epi32(_mm_set1_epi32(i), lanes), vbits);
+        const __m256i shifts = _mm256_cvtepu32_epi64(_mm_and_si128(pos, vseven));
+        __m256i values = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(bytes), _mm_srli_epi32(pos, 3), 1);
+        values = _mm256_and_si256(_mm256_srlv_epi64(values, shifts), vmask);
+        /* Move the low halves of the four 64 bit lanes into the lower 128 bits. */
+        const __m128i low = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, vpermute));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi32(low, vbase));
+    }
+#endif
+    for (; i != n; ++i) {
+        const uint64_t pos = i * bits;
+        uint64_t word;
+        std::memcpy(&word, bytes + pos / 8, sizeof(word));
+        out[i] = int32_t(uint32_t(base) + uint32_t((word >> (pos % 8)) & mask));
+    }
+}
+
+}
+
+/** A table of 32 bit integer columns in a PAX layout whose minipages are compressed with frame-of-reference encoding
+ * and bit-packing: every minipage stores the values of its column in the block as offsets to the smallest of them,
+ * with just as many bits as the largest offset needs.  The base and the bit width of every minipage are kept as
+ * metadata of the block.  Blocks are filled with rows as long as the packed minipages fit, hence the narrower the
+ * values of a block, the more rows it holds.  Rows are appended to an open block, which is packed when the next row
+ * would not fit or on `flush()`.  Without compression, every value takes 32 bits, as in a plain PAX layout. */
+struct bitpacked_pax_table
+{
+    using size_type = std::size_t;
+
+    /** The metadata of a minipage. */
+    struct minipage
+    {
+        int32_t base; ///< the smallest value of the minipage
+        uint8_t bits; ///< the number of bits of every value
+        uint32_t offset_in_words; ///< the offset of the minipage in its block
+    };
+
+    /** The metadata of a block. */
+    struct block
+    {
+        size_type num_tuples; ///< the number of rows of the block
+        std::vector<minipage> minipages; ///< the minipage of every column
+    };
+
+    private:
+    size_type num_columns_;
+    size_type words_per_block_;
+    bool compress_;
+    std::vector<block> blocks_;
+    std::vector<uint64_t> words_; ///< the data of all blocks, followed by a padding word for unpacking
+    size_type num_tuples_ = 0;
+
+    /* The open block, column-wise, and the smallest and largest value of every column in it. */
+    std::vector<std::vector<int32_t>> open_columns_;
+    std::vector<int32_t> open_min_, open_max_;
+
+    static unsigned bit_width(int32_t min, int32_t max) { return std::bit_width(uint32_t(max) - uint32_t(min)); }
+
+    ///> returns the number of words of a minipage of `n` values of `bits` bits each
+    static size_type minipage_words(size_type n, unsigned bits) { return (n * bits + 63) / 64; }
+
+    ///> returns `true` iff the open block with the additional row `row` fits into a block
+    bool fits(const int32_t *row) const {
+        const size_type n = open_columns_.front().size() + 1;
+        size_type words = 0;
+        for (size_type c = 0; c != num_columns_; ++c) {
+            const unsigned bits = compress_ ? bit_width(std::min(open_min_[c], row[c]), std::max(open_max_[c], row[c]))
+                                            : 32;
+            words += minipage_words(n, bits);
+        }
+        return words <= words_per_block_;
+    }
+
+    public:
+    /** Creates a table of \p num_columns columns in blocks of \p block_size_in_bytes bytes, which compresses the
+     * minipages iff \p compress. */
+    explicit bitpacked_pax_table(size_type num_columns, size_type block_size_in_bytes = 4096, bool compress = true)
+        : num_columns_(num_columns)
+        , words_per_block_(block_size_in_bytes / sizeof(uint64_t))
+        , compress_(compress)
+        , words_(1, 0)
+        , open_columns_(num_columns)
+        , open_min_(num_columns)
+        , open_max_(num_columns)
+    {
+        M_insist(num_columns > 0, "the table must have a column");
+        M_insist(words_per_block_ >= num_columns, "the block must hold a row of 32 bit values");
+    }
+
+    bitpacked_pax_table(const bitpacked_pax_table&) = delete;
+    bitpacked_pax_table(bitpacked_pax_table&&) = default;
+
+    ///> returns the number of columns
+    size_type num_columns() const { return num_columns_; }
+    ///> returns the number of rows, including those of the open block
+    size_type size() const { return num_tuples_; }
+    ///> returns the metadata of the packed blocks
+    const std::vector<block> & blocks() const { return blocks_; }
+    ///> returns the bytes of the packed blocks and their metadata
+    size_type size_in_bytes() const {
+        return blocks_.size() * (words_per_block_ * sizeof(uint64_t) + sizeof(block) + num_columns_ * sizeof(minipage));
+    }
+
+    /** Appends the row \p row of `num_columns()` values. */
+    void append(const int32_t *row) {
+        if (not open_columns_.front().empty() and not fits(row))
+            flush();
+        const bool first = open_columns_.front().empty();
+        for (size_type c = 0; c != num_columns_; ++c) {
+            open_columns_[c].push_back(row[c]);
+            open_min_[c] = first ? row[c] : std::min(open_min_[c], row[c]);
+            open_max_[c] = first ? row[c] : std::max(open_max_[c], row[c]);
+        }
+        ++num_tuples_;
+    }
+
+    /** Packs the open block, if it holds any rows. */
+    void flush() {
+        const size_type n = open_columns_.front().size();
+        if (n == 0) return;
+
+        /* Allocate the block before the padding word. */
+        const size_type first_word = words_.size() - 1;
+        words_.resize(words_.size() + words_per_block_, 0);
+        auto &b = blocks_.emplace_back(block{ n, {} });
+        size_type offset = 0;
+        for (size_type c = 0; c != num_columns_; ++c) {
+            const unsigned bits = compress_ ? bit_width(open_min_[c], open_max_[c]) : 32;
+            const int32_t base = compress_ ? open_min_[c] : 0;
+            b.minipages.push_back(minipage{ base, uint8_t(bits), uint32_t(offset) });
+            detail::pack(open_columns_[c].data(), n, bits, base, &words_[first_word + offset]);
+            offset += minipage_words(n, bits);
+            open_columns_[c].clear();
+        }
+    }
+
+    /** Scans the packed blocks and calls \p fn with the values of the columns \p columns of every block, i.e. with an
+     * array of pointers to the values of every column of \p columns and the number of rows of the block.  Only the
+     * minipages of \p columns are unpacked.  Rows of the open block are not scanned. */
+    template<typename Fn>
+    void scan(const std::vector<size_type> &columns, Fn &&fn) const {
+        size_type max_tuples = 0;
+        for (auto &b : blocks_)
+            max_tuples = std::max(max_tuples, b.num_tuples);
+        std::vector<std::vector<int32_t>> buffers(columns.size(), std::vector<int32_t>(max_tuples));
+        std::vector<const int32_t*> values(columns.size());
+        for (size_type i = 0; i != blocks_.size(); ++i) {
+            const block &b = blocks_[i];
+            const uint64_t *block_words = &words_[i * words_per_block_];
+            for (size_type c = 0; c != columns.size(); ++c) {
+                const minipage &mp = b.minipages[columns[c]];
+                detail::unpack(block_words + mp.offset_in_words, b.num_tuples, mp.bits, mp.base, buffers[c].data());
+                values[c] = buffers[c].data();
+            }
+            fn(values.data(), b.num_tuples);
+        }
+    }
+};
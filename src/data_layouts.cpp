@@ -1,5 +1,10 @@
 #include "data_layouts.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <map>
 #include <numeric>
+#include <stdexcept>
+#include <string>
 
 #include<iostream>
 #include<cmath>
@@ -14,6 +19,12 @@ typedef std::pair<std::size_t, std::size_t> strideAndOffset;
 //typedef std::pair<const Type*, std::size_t, std::size_t> typeIndex;
 typedef std::pair<const Type*, std::pair<std::size_t, std::size_t>> typeIndexRow;
 
+/* Rounds `offset` up to the next multiple of `alignment`. */
+std::size_t roundUp(std::size_t offset, std::size_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
 bool sortTypePairsRow(typeIndexRow left, typeIndexRow right)
 {
     return left.first->alignment() > right.first->alignment();
@@ -134,6 +145,74 @@ DataLayout MyOptimizedRowLayoutFactory::make(std::vector<const Type*> types, std
    return layout;
 }
 
+DataLayout MyOutOfLineRowLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const std::size_t num_tuples_per_chunk = num_tuples ? num_tuples : NUM_TUPLES_PER_CHUNK;
+    const Type* bitmap = Type::Get_Bitmap(Type::TY_Vector, types.size());
+
+    /* Split the attributes into the wide character sequences and the attributes of the rows. */
+    std::vector<std::size_t> inline_attributes, wide_attributes;
+    for (std::size_t idx = 0; idx != types.size(); ++idx)
+    {
+        if (types[idx]->is_character_sequence() and types[idx]->size() > threshold_in_bytes_ * 8)
+            wide_attributes.push_back(idx);
+        else
+            inline_attributes.push_back(idx);
+    }
+
+    /* Lay out the rows with the attributes in descending alignment order, followed by the NULL bitmap. */
+    std::stable_sort(inline_attributes.begin(), inline_attributes.end(), [&types](std::size_t left, std::size_t right) {
+        return types[left]->alignment() > types[right]->alignment();
+    });
+    std::vector<std::size_t> offsets;
+    std::size_t offset = 0;
+    std::size_t max_align = 8;
+    for (std::size_t idx : inline_attributes)
+    {
+        offset = roundUp(offset, types[idx]->alignment());
+        offsets.push_back(offset);
+        offset += types[idx]->size();
+        max_align = std::max(max_align, types[idx]->alignment());
+    }
+    const std::size_t bitmap_offset = offset;
+    const std::size_t row_stride = roundUp(offset + bitmap->size(), max_align);
+
+    DataLayout layout;
+    std::size_t heap_offset = roundUp(row_stride * num_tuples_per_chunk, CACHE_LINE_SIZE_IN_BITS);
+    std::size_t chunk_size = heap_offset;
+    for (std::size_t idx : wide_attributes)
+        chunk_size = roundUp(chunk_size + types[idx]->size() * num_tuples_per_chunk, CACHE_LINE_SIZE_IN_BITS);
+    auto& chunk = layout.add_inode(/* num_tuples = */ num_tuples_per_chunk, /* stride_in_bits = */ chunk_size);
+
+    auto& rows = chunk.add_inode(/* num_tuples = */ 1, /* offset = */ 0, /* stride = */ row_stride);
+    for (std::size_t i = 0; i != inline_attributes.size(); ++i)
+    {
+        rows.add_leaf(
+            /* type = */ types[inline_attributes[i]],
+            /* idx = */ inline_attributes[i],
+            /* offset = */ offsets[i],
+            /* stride = */ 0);
+    }
+    rows.add_leaf(
+        /* type = */ bitmap,
+        /* idx = */ types.size(),
+        /* offset = */ bitmap_offset,
+        /* stride = */ 0);
+
+    /* Store the values of every wide attribute contiguously in a heap region following the rows. */
+    for (std::size_t idx : wide_attributes)
+    {
+        chunk.add_leaf(
+            /* type = */ types[idx],
+            /* idx = */ idx,
+            /* offset = */ heap_offset,
+            /* stride = */ types[idx]->size());
+        heap_offset = roundUp(heap_offset + types[idx]->size() * num_tuples_per_chunk, CACHE_LINE_SIZE_IN_BITS);
+    }
+
+    return layout;
+}
+
 bool sortTypePairs(typeIndex left, typeIndex right)
 {
     return left.first->alignment() > right.first->alignment();
@@ -154,7 +233,9 @@ std::vector<typeIndex> sortTypesKeepIndex(std::vector<const Type*> types)
 
 }
 
-std::vector<strideAndOffset> calculateIndexedStrideAndOffset (std::vector<const Type*> types, std::size_t total_tuples)
+/* Places the minipages of `total_tuples` tuples one after another, each starting at a multiple of `alignment` bits. */
+std::vector<strideAndOffset> calculateIndexedStrideAndOffset (std::vector<const Type*> types, std::size_t total_tuples,
+                                                              std::size_t alignment = 1)
 {
     /* Create new vector with the size of types vector */
     std::vector<strideAndOffset> indexedStrideAndOffset = std::vector<strideAndOffset>(types.size());
@@ -168,15 +249,74 @@ std::vector<strideAndOffset> calculateIndexedStrideAndOffset (std::vector<const
     {
         std::size_t size = type.first->size();
         indexedStrideAndOffset[type.second] = std::make_pair(size, offset);
-        offset += size * total_tuples;
+        offset = roundUp(offset + size * total_tuples, alignment);
     }
     return indexedStrideAndOffset;
 
 }
 
-DataLayout MyPAX4kLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+/* Adds the minipages of `total_tuples` tuples of `types`, including the NULL bitmap, to the PAX block `block`. */
+void addPAXMinipages(DataLayout::INode& block, const std::vector<const Type*>& types, std::size_t total_tuples,
+                     std::size_t alignment)
 {
-    std::size_t block_size = 4096 * 8;
+    /* Reorder leafs to optimize memory allocation */
+    std::vector<strideAndOffset> indexedStrideAndOffset = calculateIndexedStrideAndOffset(types, total_tuples,
+                                                                                         alignment);
+    std::size_t idx = 0;
+    for(const Type* type : types)
+    {
+        strideAndOffset strideAndOffset = indexedStrideAndOffset[idx];
+        block.add_leaf(
+            /* type = */ type,
+            /* idx = */ idx,
+            /* offset = */ strideAndOffset.second,
+            /* stride = */ strideAndOffset.first);
+        idx++;
+    }
+}
+
+std::size_t detect_cache_size(unsigned level)
+{
+    for (unsigned index = 0; ; ++index)
+    {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + '/';
+        std::ifstream level_in(dir + "level"), type_in(dir + "type"), size_in(dir + "size");
+        if (not level_in)
+            return 0; // no more caches
+        unsigned cache_level;
+        std::string type, size;
+        if (not (level_in >> cache_level) or not (type_in >> type) or not (size_in >> size))
+            continue;
+        if (cache_level != level or type == "Instruction")
+            continue;
+
+        /* The size is given as a number followed by an optional unit, e.g. `48K`. */
+        char *unit;
+        std::size_t size_in_bytes = std::strtoul(size.c_str(), &unit, 10);
+        switch (*unit)
+        {
+            case 'G': size_in_bytes *= 1024; [[fallthrough]];
+            case 'M': size_in_bytes *= 1024; [[fallthrough]];
+            case 'K': size_in_bytes *= 1024; break;
+            default: break;
+        }
+        return size_in_bytes;
+    }
+}
+
+MyPAXLayoutFactory::MyPAXLayoutFactory(std::size_t block_size_in_bytes, bool aligned)
+    : block_size_in_bytes_(block_size_in_bytes)
+    , aligned_(aligned)
+{
+    if (block_size_in_bytes_ == AUTO)
+        block_size_in_bytes_ = detect_cache_size(2);
+    if (block_size_in_bytes_ == 0)
+        block_size_in_bytes_ = 4096;
+}
+
+DataLayout MyPAXLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    std::size_t block_size = block_size_in_bytes_ * 8;
     types.push_back(Type::Get_Bitmap(Type::TY_Vector, types.size()));
     DataLayout layout;
 
@@ -189,20 +329,236 @@ DataLayout MyPAX4kLayoutFactory::make(std::vector<const Type*> types, std::size_
     }
     std::size_t total_tuples = block_size / total_bits;
 
+    std::size_t alignment = 1;
+    if (aligned_)
+    {
+        /* The narrowest attribute, but at least a byte, determines the number of SIMD lanes. */
+        std::size_t min_size = SIMD_WIDTH_IN_BITS;
+        for (std::size_t idx = 0; idx + 1 < types.size(); ++idx)
+            min_size = std::min(min_size, std::max<std::size_t>(types[idx]->size(), 8));
+        const std::size_t num_lanes = SIMD_WIDTH_IN_BITS / min_size;
+        alignment = CACHE_LINE_SIZE_IN_BITS;
+
+        /* Remove lanes of tuples until the aligned minipages fit into the block, but keep at least one lane. */
+        auto minipagesEnd = [&](std::size_t n) {
+            std::size_t end = 0;
+            for (const strideAndOffset& minipage : calculateIndexedStrideAndOffset(types, n, alignment))
+                end = std::max(end, minipage.second + minipage.first * n);
+            return end;
+        };
+        total_tuples = std::max(total_tuples / num_lanes * num_lanes, num_lanes);
+        while (total_tuples > num_lanes and minipagesEnd(total_tuples) > block_size)
+            total_tuples -= num_lanes;
+        block_size = std::max(block_size, roundUp(minipagesEnd(total_tuples), alignment));
+    }
+
     auto& row = layout.add_inode(/* num_tuples = */ total_tuples, /* stride_in_bits = */ block_size);
-    /* Reorder leafs to optimize memory allocation */
-    std::vector<strideAndOffset> indexedStrideAndOffset = calculateIndexedStrideAndOffset(types, total_tuples);
+    addPAXMinipages(row, types, total_tuples, alignment);
+
+    return layout;
+}
+
+MyHugePagePAXLayoutFactory::MyHugePagePAXLayoutFactory(std::size_t sub_block_size_in_bytes,
+                                                       std::size_t page_size_in_bytes)
+    : sub_block_size_in_bytes_(sub_block_size_in_bytes)
+    , page_size_in_bytes_(page_size_in_bytes)
+{
+    if (sub_block_size_in_bytes_ == 0 or page_size_in_bytes_ % sub_block_size_in_bytes_ != 0)
+        throw std::invalid_argument("the page size must be a multiple of the sub-block size");
+}
+
+DataLayout MyHugePagePAXLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const std::size_t sub_block_size = sub_block_size_in_bytes_ * 8;
+    types.push_back(Type::Get_Bitmap(Type::TY_Vector, types.size()));
+
+    /* Fill the sub-blocks as in the PAX layout, and the pages with sub-blocks. */
+    std::size_t total_bits = 0;
+    for (const Type* type : types)
+        total_bits += type->size();
+    const std::size_t num_tuples_per_sub_block = sub_block_size / total_bits;
+    const std::size_t num_sub_blocks = page_size_in_bytes_ / sub_block_size_in_bytes_;
+
+    DataLayout layout;
+    auto& page = layout.add_inode(/* num_tuples = */ num_sub_blocks * num_tuples_per_sub_block,
+                                  /* stride_in_bits = */ page_size_in_bytes_ * 8);
+    auto& sub_block = page.add_inode(/* num_tuples = */ num_tuples_per_sub_block, /* offset = */ 0,
+                                     /* stride = */ sub_block_size);
+    addPAXMinipages(sub_block, types, num_tuples_per_sub_block, /* alignment = */ 1);
+
+    return layout;
+}
+
+DataLayout MyColumnarLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const std::size_t num_tuples_per_block = num_tuples ? num_tuples : NUM_TUPLES_PER_CHUNK;
+    types.push_back(Type::Get_Bitmap(Type::TY_Vector, types.size()));
+
+    /* Place the columns one after another and align the start of every column. */
+    std::vector<std::size_t> offsets;
+    std::size_t offset = 0;
+    for (const Type* type : types)
+    {
+        offsets.push_back(offset);
+        offset += type->size() * num_tuples_per_block;
+        offset = roundUp(offset, CACHE_LINE_SIZE_IN_BITS);
+    }
+
+    DataLayout layout;
+    auto& block = layout.add_inode(/* num_tuples = */ num_tuples_per_block, /* stride_in_bits = */ offset);
     std::size_t idx = 0;
-    for(const Type* type : types)
+    for (const Type* type : types)
     {
-        strideAndOffset strideAndOffset = indexedStrideAndOffset[idx];
-        row.add_leaf(
+        block.add_leaf(
             /* type = */ type,
             /* idx = */ idx,
-            /* offset = */ strideAndOffset.second,
-            /* stride = */ strideAndOffset.first);
+            /* offset = */ offsets[idx],
+            /* stride = */ type->size());
         idx++;
     }
 
     return layout;
-}
\ No newline at end of file
+}
+
+MyColumnGroupLayoutFactory::MyColumnGroupLayoutFactory(std::vector<group_type> groups, std::size_t block_size_in_bytes)
+    : groups_(std::move(groups))
+    , block_size_in_bytes_(block_size_in_bytes)
+{
+    std::vector<bool> grouped;
+    for (const group_type& group : groups_)
+    {
+        for (std::size_t idx : group)
+        {
+            if (grouped.size() <= idx)
+                grouped.resize(idx + 1, false);
+            if (grouped[idx])
+                throw std::invalid_argument("attribute " + std::to_string(idx) + " is in more than one column group");
+            grouped[idx] = true;
+        }
+    }
+}
+
+MyColumnGroupLayoutFactory MyColumnGroupLayoutFactory::FromWorkload(const std::vector<workload_query> &workload,
+                                                                    const std::string &table,
+                                                                    const std::vector<std::string> &attributes,
+                                                                    std::size_t block_size_in_bytes)
+{
+    /* Compute for every attribute the signature of the queries that access it. */
+    std::vector<std::vector<bool>> signatures(attributes.size());
+    for (const workload_query& query : workload)
+    {
+        std::vector<bool> accessed = query.accessed_attributes(table, attributes);
+        for (std::size_t idx = 0; idx != attributes.size(); ++idx)
+            signatures[idx].push_back(accessed[idx]);
+    }
+
+    /* Group the attributes with the same signature, except for attributes that no query accesses. */
+    std::vector<group_type> groups;
+    std::map<std::vector<bool>, std::size_t> group_of_signature;
+    for (std::size_t idx = 0; idx != attributes.size(); ++idx)
+    {
+        const auto& signature = signatures[idx];
+        if (std::find(signature.begin(), signature.end(), true) == signature.end())
+            continue;
+        auto [it, inserted] = group_of_signature.try_emplace(signature, groups.size());
+        if (inserted)
+            groups.emplace_back();
+        groups[it->second].push_back(idx);
+    }
+
+    return MyColumnGroupLayoutFactory(std::move(groups), block_size_in_bytes);
+}
+
+DataLayout MyColumnGroupLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const std::size_t num_attributes = types.size();
+    const Type* bitmap = Type::Get_Bitmap(Type::TY_Vector, num_attributes);
+
+    /* Collect the groups of the attributes; the attributes in no group form the group of rarely accessed ones. */
+    std::vector<group_type> groups;
+    std::vector<bool> grouped(num_attributes, false);
+    for (const group_type& group : groups_)
+    {
+        group_type attributes;
+        for (std::size_t idx : group)
+        {
+            if (idx < num_attributes)
+            {
+                attributes.push_back(idx);
+                grouped[idx] = true;
+            }
+        }
+        if (not attributes.empty())
+            groups.push_back(std::move(attributes));
+    }
+    group_type rest;
+    for (std::size_t idx = 0; idx != num_attributes; ++idx)
+    {
+        if (not grouped[idx])
+            rest.push_back(idx);
+    }
+    if (not rest.empty())
+        groups.push_back(std::move(rest));
+
+    /* Lay out the rows of every group with the attributes in descending alignment order, as in the optimized row
+     * layout, and compute the stride of the rows. */
+    std::vector<std::vector<std::size_t>> offsets; // the offset of every attribute within the row of its group
+    std::vector<std::size_t> strides;
+    std::size_t bits_per_tuple = bitmap->size();
+    for (group_type& group : groups)
+    {
+        std::stable_sort(group.begin(), group.end(), [&types](std::size_t left, std::size_t right) {
+            return types[left]->alignment() > types[right]->alignment();
+        });
+        std::vector<std::size_t> group_offsets;
+        std::size_t offset = 0;
+        std::size_t max_align = 8;
+        for (std::size_t idx : group)
+        {
+            offset = roundUp(offset, types[idx]->alignment());
+            group_offsets.push_back(offset);
+            offset += types[idx]->size();
+            max_align = std::max(max_align, types[idx]->alignment());
+        }
+        offsets.push_back(std::move(group_offsets));
+        strides.push_back(roundUp(offset, max_align));
+        bits_per_tuple += strides.back();
+    }
+
+    /* Fit as many tuples into a block as the minipages and their alignment permit. */
+    auto minipages_size = [&](std::size_t n) {
+        std::size_t offset = 0;
+        for (std::size_t stride : strides)
+            offset = roundUp(offset + stride * n, CACHE_LINE_SIZE_IN_BITS);
+        return offset + bitmap->size() * n;
+    };
+    const std::size_t block_size = block_size_in_bytes_ * 8;
+    std::size_t num_tuples_per_block = std::max<std::size_t>(block_size / bits_per_tuple, 1);
+    while (num_tuples_per_block > 1 and minipages_size(num_tuples_per_block) > block_size)
+        --num_tuples_per_block;
+
+    DataLayout layout;
+    auto& block = layout.add_inode(/* num_tuples = */ num_tuples_per_block,
+                                   /* stride_in_bits = */ std::max(block_size, minipages_size(num_tuples_per_block)));
+    std::size_t offset = 0;
+    for (std::size_t g = 0; g != groups.size(); ++g)
+    {
+        auto& rows = block.add_inode(/* num_tuples = */ 1, /* offset = */ offset, /* stride = */ strides[g]);
+        for (std::size_t i = 0; i != groups[g].size(); ++i)
+        {
+            rows.add_leaf(
+                /* type = */ types[groups[g][i]],
+                /* idx = */ groups[g][i],
+                /* offset = */ offsets[g][i],
+                /* stride = */ 0);
+        }
+        offset = roundUp(offset + strides[g] * num_tuples_per_block, CACHE_LINE_SIZE_IN_BITS);
+    }
+    block.add_leaf(
+        /* type = */ bitmap,
+        /* idx = */ num_attributes,
+        /* offset = */ offset,
+        /* stride = */ bitmap->size());
+
+    return layout;
+}
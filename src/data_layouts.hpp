@@ -1,10 +1,14 @@
 #pragma once
 
 
+#include "workload.hpp"
 #include <mutable/mutable.hpp>
 #include <mutable/storage/DataLayoutFactory.hpp>
 
 
+///> the size of a cache line, in bits, to which the layouts align minipages, columns, and heap regions
+constexpr std::size_t CACHE_LINE_SIZE_IN_BITS = 64 * 8;
+
 struct MyNaiveRowLayoutFactory : m::storage::DataLayoutFactory
 {
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
@@ -15,7 +19,129 @@ struct MyOptimizedRowLayoutFactory : m::storage::DataLayoutFactory
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
 };
 
-struct MyPAX4kLayoutFactory : m::storage::DataLayoutFactory
+/** Returns the size in bytes of the data or unified cache of level \p level of the first CPU, as reported in
+ * `/sys/devices/system/cpu/cpu0/cache`, or 0 if the size cannot be detected. */
+std::size_t detect_cache_size(unsigned level);
+
+/** A row layout that stores wide character sequences out of line.  Every `CHAR(N)` attribute with `N` greater than the
+ * threshold gets a heap region of its own, in which its values are stored contiguously, while the other attributes and
+ * the NULL bitmap are stored row-wise, as in the optimized row layout.  The value of a wide attribute is referenced by
+ * the index of the row within its chunk, hence the rows need no bytes for the reference.  Row-wise scans of the other
+ * attributes thus touch far fewer cache lines.  If the number of tuples is known, e.g. for a bulkloaded table, all
+ * tuples are stored in a single chunk of rows and heap regions.  Otherwise, every chunk holds `NUM_TUPLES_PER_CHUNK`
+ * tuples. */
+struct MyOutOfLineRowLayoutFactory : m::storage::DataLayoutFactory
+{
+    ///> the number of tuples per chunk, if the number of tuples is not known
+    static constexpr std::size_t NUM_TUPLES_PER_CHUNK = 1UL << 12;
+
+    private:
+    std::size_t threshold_in_bytes_;
+
+    public:
+    /** Creates a factory that stores character sequences of more than \p threshold_in_bytes characters out of line. */
+    explicit MyOutOfLineRowLayoutFactory(std::size_t threshold_in_bytes = 32)
+        : threshold_in_bytes_(threshold_in_bytes)
+    { }
+
+    std::size_t threshold_in_bytes() const { return threshold_in_bytes_; }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A PAX layout factory with blocks of a configurable size.  A block size of `AUTO` sizes the blocks to the L2 cache,
+ * as detected with `detect_cache_size()`, or to 4 KiB if the cache size cannot be detected.  If the layout is
+ * `aligned`, every minipage starts at a cache line boundary and the number of tuples per block is a multiple of the
+ * SIMD lanes of the narrowest attribute, such that vectorized scans use aligned loads that never split a cache line.
+ * This trades the padding of the minipages and fewer tuples per block for faster scans. */
+struct MyPAXLayoutFactory : m::storage::DataLayoutFactory
+{
+    static constexpr std::size_t AUTO = 0;
+    ///> the width of a SIMD register, in bits, which determines the number of lanes of an attribute
+    static constexpr std::size_t SIMD_WIDTH_IN_BITS = 512;
+
+    private:
+    std::size_t block_size_in_bytes_;
+    bool aligned_;
+
+    public:
+    explicit MyPAXLayoutFactory(std::size_t block_size_in_bytes = AUTO, bool aligned = false);
+
+    std::size_t block_size_in_bytes() const { return block_size_in_bytes_; }
+    bool aligned() const { return aligned_; }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+struct MyPAX4kLayoutFactory : MyPAXLayoutFactory
 {
+    MyPAX4kLayoutFactory() : MyPAXLayoutFactory(4096) { }
+};
+
+/** A two-level PAX layout for large tables: the outer blocks have the size of a huge page, 2 MiB by default, and every
+ * outer block is a sequence of PAX sub-blocks of 4 KiB by default.  A scan thus walks through few pages, which cuts the
+ * TLB misses when the store backs the outer blocks with huge pages, while the minipages of a sub-block stay small
+ * enough for the L1 cache.  The sub-blocks of an outer block are laid out back to back. */
+struct MyHugePagePAXLayoutFactory : m::storage::DataLayoutFactory
+{
+    ///> the size of a huge page on x86-64, in bytes
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2UL * 1024 * 1024;
+
+    private:
+    std::size_t sub_block_size_in_bytes_;
+    std::size_t page_size_in_bytes_;
+
+    public:
+    /** Creates a factory for outer blocks of \p page_size_in_bytes bytes of sub-blocks of \p sub_block_size_in_bytes
+     * bytes.  Throws `std::invalid_argument` unless the page size is a multiple of the sub-block size. */
+    explicit MyHugePagePAXLayoutFactory(std::size_t sub_block_size_in_bytes = 4096,
+                                        std::size_t page_size_in_bytes = HUGE_PAGE_SIZE);
+
+    std::size_t sub_block_size_in_bytes() const { return sub_block_size_in_bytes_; }
+    std::size_t page_size_in_bytes() const { return page_size_in_bytes_; }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A columnar layout (DSM) that stores every attribute and the NULL bitmap as a contiguous column, each starting at a
+ * cache line boundary, which is also the widest SIMD alignment.  If the number of tuples is known, e.g. for a
+ * bulkloaded table, all tuples are stored in a single block of columns.  Otherwise, the columns are split into chunks
+ * of `NUM_TUPLES_PER_CHUNK` tuples. */
+struct MyColumnarLayoutFactory : m::storage::DataLayoutFactory
+{
+    ///> the number of tuples per chunk of columns, if the number of tuples is not known
+    static constexpr std::size_t NUM_TUPLES_PER_CHUNK = 1UL << 16;
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A hybrid layout that partitions the attributes vertically into column groups.  Every block of `block_size_in_bytes`
+ * bytes holds one minipage per column group, in which the attributes of the group are stored row-wise, and one for the
+ * NULL bitmap.  Attributes that are in no group form one additional group of rarely accessed attributes.  Hence, a
+ * query that accesses only attributes of one group reads no bytes of other groups, while the attributes of a group
+ * share their cache lines. */
+struct MyColumnGroupLayoutFactory : m::storage::DataLayoutFactory
+{
+    using group_type = std::vector<std::size_t>; ///< the indices of the attributes of a column group
+
+    private:
+    std::vector<group_type> groups_;
+    std::size_t block_size_in_bytes_;
+
+    public:
+    /** Creates a factory for the column groups \p groups.  Attribute indices beyond the attributes of a table are
+     * ignored.  Throws `std::invalid_argument` if an attribute is in more than one group. */
+    explicit MyColumnGroupLayoutFactory(std::vector<group_type> groups, std::size_t block_size_in_bytes = 64 * 1024);
+
+    /** Derives the column groups of the attributes \p attributes of table \p table from the co-access patterns of the
+     * queries \p workload: attributes that are accessed by exactly the same queries form a group.  Attributes that
+     * no query accesses end up in the group of rarely accessed attributes. */
+    static MyColumnGroupLayoutFactory FromWorkload(const std::vector<workload_query> &workload,
+                                                   const std::string &table, const std::vector<std::string> &attributes,
+                                                   std::size_t block_size_in_bytes = 64 * 1024);
+
+    const std::vector<group_type> & groups() const { return groups_; }
+    std::size_t block_size_in_bytes() const { return block_size_in_bytes_; }
+
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
 };
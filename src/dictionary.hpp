@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/** A dictionary-encoded column of fixed-width character sequences, e.g. of a `CHAR(N)` attribute with few distinct
+ * values.  Every distinct value is stored once in the dictionary, and every row stores the code of its value, i.e.
+ * the index of the value in the dictionary, as \tparam Code, which is meant to be a 1 or 2 byte integer.  Codes are
+ * assigned in the order values are first appended, such that the column can be built while loading rows.  Equality
+ * predicates and grouping compare codes instead of values.
+ *
+ * @tparam N     the number of characters of a value
+ * @tparam Code  the unsigned integer type of the codes, which limits the number of distinct values */
+template<std::size_t N, std::unsigned_integral Code = uint8_t>
+struct dictionary_column
+{
+    using value_type = std::array<char, N>;
+    using code_type = Code;
+    using size_type = std::size_t;
+
+    ///> the maximum number of distinct values of the column
+    static constexpr size_type MAX_NUM_DISTINCT = size_type(std::numeric_limits<code_type>::max()) + 1;
+
+    private:
+    std::vector<value_type> dictionary_; ///< the distinct values, indexed by their code
+    std::unordered_map<std::string, code_type> codes_; ///< maps every distinct value to its code
+    std::vector<code_type> column_; ///< the code of every row
+
+    static std::string key(const value_type &value) { return std::string(value.data(), N); }
+
+    public:
+    /** Appends a row with value \p value.  Returns `false` and appends nothing if \p value is not yet in the dictionary
+     * and the dictionary is full, in which case the column should rather be stored unencoded. */
+    bool append(const value_type &value) {
+        auto it = codes_.find(key(value));
+        if (it == codes_.end()) {
+            if (dictionary_.size() == MAX_NUM_DISTINCT) return false;
+            it = codes_.emplace(key(value), code_type(dictionary_.size())).first;
+            dictionary_.push_back(value);
+        }
+        column_.push_back(it->second);
+        return true;
+    }
+
+    ///> returns the number of rows
+    size_type size() const { return column_.size(); }
+    ///> returns the number of distinct values
+    size_type num_distinct() const { return dictionary_.size(); }
+    ///> returns the code of row \p i
+    code_type code(size_type i) const { return column_[i]; }
+    ///> returns the value of row \p i
+    const value_type & operator[](size_type i) const { return dictionary_[column_[i]]; }
+    ///> returns the value of code \p code
+    const value_type & decode(code_type code) const { return dictionary_[code]; }
+    ///> returns the codes of all rows
+    const std::vector<code_type> & codes() const { return column_; }
+
+    /** Returns the code of \p value, or nothing if no row has value \p value. */
+    std::optional<code_type> find(const value_type &value) const {
+        auto it = codes_.find(key(value));
+        if (it == codes_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    /** Returns the number of rows with value \p value, comparing codes only. */
+    size_type count_equal(const value_type &value) const {
+        const auto code = find(value);
+        return code ? std::count(column_.begin(), column_.end(), *code) : 0;
+    }
+
+    /** Groups the rows by value and returns the number of rows of every group, indexed by the code of its value. */
+    std::vector<size_type> count_by_code() const {
+        std::vector<size_type> counts(dictionary_.size(), 0);
+        for (code_type code : column_)
+            ++counts[code];
+        return counts;
+    }
+
+    /** Returns the bytes of the codes and of the dictionary, without the hash table used while appending. */
+    size_type size_in_bytes() const { return column_.size() * sizeof(code_type) + dictionary_.size() * N; }
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+/** An equi-depth histogram over the keys of type \tparam Key of an index, e.g. derived with `BTree::histogram()`.
+ * Every bucket holds about the same number of keys.  Buckets are formed by rank, hence the keys of a run of equal keys
+ * may be spread over adjacent buckets. */
+template<typename Key>
+struct equi_depth_histogram
+{
+    using key_type = Key;
+    using size_type = std::size_t;
+
+    struct bucket
+    {
+        key_type lo; ///< the smallest key of the bucket
+        key_type hi; ///< the largest key of the bucket
+        size_type count; ///< the number of keys of the bucket
+        double num_distinct; ///< the (estimated) number of distinct keys of the bucket
+    };
+
+    std::vector<bucket> buckets; ///< the buckets in key order
+    size_type num_keys = 0; ///< the number of keys of the index
+    double num_distinct = 0; ///< the (estimated) number of distinct keys of the index
+
+    /** Estimates the number of keys less than \p key.  Within a bucket, arithmetic keys are assumed to be distributed
+     * uniformly between the bucket's smallest and largest key; for other keys, half of the bucket is assumed. */
+    double estimate_less(const key_type &key) const {
+        double estimate = 0;
+        for (const bucket &b : buckets) {
+            if (not (b.lo < key)) break;
+            if (b.hi < key) {
+                estimate += b.count;
+                continue;
+            }
+            /* `b.lo < key <= b.hi` */
+            if constexpr (std::is_arithmetic_v<key_type>)
+                estimate += b.count * ((double(key) - double(b.lo)) / (double(b.hi) - double(b.lo)));
+            else
+                estimate += b.count / 2.;
+            break;
+        }
+        return estimate;
+    }
+
+    /** Estimates the number of keys equal to \p key, assuming all distinct keys of a bucket are equally frequent. */
+    double estimate_equal(const key_type &key) const {
+        double estimate = 0;
+        for (const bucket &b : buckets) {
+            if (key < b.lo) break;
+            if (not (b.hi < key)) estimate += b.count / std::max(1., b.num_distinct);
+        }
+        return estimate;
+    }
+
+    /** Estimates the number of keys in the interval `[lo, hi)`. */
+    double estimate_range(const key_type &lo, const key_type &hi) const {
+        return lo < hi ? std::max(0., estimate_less(hi) - estimate_less(lo)) : 0.;
+    }
+
+    /** Estimates the fraction of keys in the interval `[lo, hi)`. */
+    double selectivity(const key_type &lo, const key_type &hi) const {
+        return num_keys ? estimate_range(lo, hi) / num_keys : 0.;
+    }
+};
+
+namespace detail {
+
+template<typename Key>
+void write_json_key(std::ostream &out, const Key &key)
+{
+    if constexpr (std::is_arithmetic_v<Key>) {
+        out << key;
+    } else {
+        /* A character sequence, e.g. `std::array<char, N>` of a `CHAR(N)` attribute, as string. */
+        std::string_view str(key.data(), key.size());
+        str = str.substr(0, str.find('\0'));
+        out << '"';
+        for (char c : str) {
+            if (c == '"' or c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+                out << escaped;
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+}
+
+}
+
+/** Writes the histogram \p histogram of attribute \p attribute of relation \p relation in the JSON format of the
+ * injected cardinalities, e.g. `resource/chain-12.cardinalities.json`, i.e. as the entry of \p relation in the list of
+ * database \p database.  The entry holds the size of the relation and, as additional field `histograms`, the number of
+ * distinct values and the buckets of the attribute. */
+template<typename Key>
+void write_cardinalities_json(std::ostream &out, const char *database, const char *relation, const char *attribute,
+                              const equi_depth_histogram<Key> &histogram)
+{
+    out << "{\n"
+        << "    \"" << database << "\": [\n"
+        << "        { \"relations\": [\"" << relation << "\"], \"size\": " << histogram.num_keys << ",\n"
+        << "          \"histograms\": {\n"
+        << "            \"" << attribute << "\": {\n"
+        << "              \"distinct\": " << std::size_t(histogram.num_distinct + .5) << ",\n"
+        << "              \"buckets\": [";
+    for (std::size_t i = 0; i != histogram.buckets.size(); ++i) {
+        const auto &b = histogram.buckets[i];
+        out << (i ? ",\n" : "\n") << "                { \"lo\": ";
+        detail::write_json_key(out, b.lo);
+        out << ", \"hi\": ";
+        detail::write_json_key(out, b.hi);
+        out << ", \"count\": " << b.count << ", \"distinct\": " << std::size_t(b.num_distinct + .5) << " }";
+    }
+    out << "\n"
+        << "              ]\n"
+        << "            }\n"
+        << "          }\n"
+        << "        }\n"
+        << "    ]\n"
+        << "}\n";
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+
+/** Hashes keys of type \tparam Key for `HashIndex` and `LookupCache`.  The result is well mixed in all bits, since
+ * `HashIndex` uses the high bits to select a group and the low bits as fingerprint. */
+template<typename Key>
+struct index_hash
+{
+    uint64_t operator()(const Key &key) const {
+        uint64_t h;
+        if constexpr (std::integral<Key>)
+            h = uint64_t(key);
+        else if constexpr (requires { std::string_view(key.data(), key.size()); })
+            h = std::hash<std::string_view>{}(std::string_view(key.data(), key.size()));
+        else
+            h = std::hash<Key>{}(key);
+        /* The finalizer of MurmurHash3. */
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdUL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53UL;
+        h ^= h >> 33;
+        return h;
+    }
+};
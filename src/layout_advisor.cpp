@@ -0,0 +1,109 @@
+#include "layout_advisor.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+/* One level on the path from the root of a layout to a leaf: the tuples of the node and where its instances lie. */
+struct pathLevel
+{
+    std::size_t num_tuples;
+    uint64_t offset_in_bits;
+    uint64_t stride_in_bits;
+};
+
+/* Collects the paths to all leaves below `node` whose index is flagged in `accessed`. */
+void collectLeafPaths(const DataLayout::Node &node, std::vector<pathLevel> &path, const std::vector<bool> &accessed,
+                      std::vector<std::pair<std::vector<pathLevel>, uint64_t>> &leaf_paths)
+{
+    if (auto leaf = cast<const DataLayout::Leaf>(&node))
+    {
+        const std::size_t idx = leaf->index();
+        const bool is_null_bitmap = idx >= accessed.size();
+        const bool any_accessed = std::find(accessed.begin(), accessed.end(), true) != accessed.end();
+        if (is_null_bitmap ? any_accessed : accessed[idx])
+            leaf_paths.emplace_back(path, leaf->type()->size());
+        return;
+    }
+    auto inode = cast<const DataLayout::INode>(&node);
+    for (std::size_t i = 0; i != inode->num_children(); ++i)
+    {
+        auto& child = inode->at(i);
+        path.push_back({ child.ptr->num_tuples(), child.offset_in_bits, child.stride_in_bits });
+        collectLeafPaths(*child.ptr, path, accessed, leaf_paths);
+        path.pop_back();
+    }
+}
+
+double estimate_bytes_touched(const DataLayout &layout, const std::vector<bool> &accessed, std::size_t num_tuples)
+{
+    if (num_tuples == 0)
+        return 0;
+
+    /* The root is a sequence of instances of its child. */
+    std::vector<std::pair<std::vector<pathLevel>, uint64_t>> leaf_paths;
+    std::vector<pathLevel> path{ { layout.child().num_tuples(), 0, layout.stride_in_bits() } };
+    collectLeafPaths(layout.child(), path, accessed, leaf_paths);
+
+    /* Enumerate the cache lines holding the values of the sampled tuples. */
+    constexpr uint64_t LINE_SIZE_IN_BITS = LAYOUT_ADVISOR_CACHE_LINE_SIZE * 8;
+    const std::size_t num_sampled = std::min(num_tuples, LAYOUT_ADVISOR_SAMPLE_TUPLES);
+    std::vector<uint64_t> lines;
+    for (auto& [levels, size_in_bits] : leaf_paths)
+    {
+        for (std::size_t tuple_id = 0; tuple_id != num_sampled; ++tuple_id)
+        {
+            /* Descend the path: the tuple is in instance `id / num_tuples` of every node on the path, at index
+             * `id % num_tuples` within the instance. */
+            uint64_t offset = 0;
+            std::size_t id = tuple_id;
+            for (const pathLevel& level : levels)
+            {
+                offset += level.offset_in_bits + (id / level.num_tuples) * level.stride_in_bits;
+                id %= level.num_tuples;
+            }
+            const uint64_t first_line = offset / LINE_SIZE_IN_BITS;
+            const uint64_t last_line = (offset + std::max<uint64_t>(size_in_bits, 1) - 1) / LINE_SIZE_IN_BITS;
+            for (uint64_t line = first_line; line <= last_line; ++line)
+                lines.push_back(line);
+        }
+    }
+    std::sort(lines.begin(), lines.end());
+    const std::size_t num_lines = std::unique(lines.begin(), lines.end()) - lines.begin();
+
+    return double(num_lines) * LAYOUT_ADVISOR_CACHE_LINE_SIZE * num_tuples / num_sampled;
+}
+
+layout_advice advise_layout(const std::vector<std::pair<std::string, const DataLayoutFactory*>> &candidates,
+                            const std::vector<workload_query> &workload, const std::string &table,
+                            const std::vector<std::string> &attributes, const std::vector<const Type*> &types,
+                            std::size_t num_tuples)
+{
+    if (candidates.empty())
+        throw std::invalid_argument("no candidate layouts");
+
+    /* Collect the attributes accessed by every query of the table. */
+    std::vector<std::vector<bool>> accesses;
+    for (const workload_query& query : workload)
+    {
+        if (query.references(table))
+            accesses.push_back(query.accessed_attributes(table, attributes));
+    }
+
+    layout_advice advice{ 0, {} };
+    for (auto& [name, factory] : candidates)
+    {
+        const DataLayout layout = factory->make(types, num_tuples);
+        double bytes_touched = 0;
+        for (const auto& accessed : accesses)
+            bytes_touched += estimate_bytes_touched(layout, accessed, num_tuples);
+        advice.costs.push_back({ name, bytes_touched });
+        if (bytes_touched < advice.costs[advice.best].bytes_touched)
+            advice.best = advice.costs.size() - 1;
+    }
+    return advice;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "workload.hpp"
+#include <cstddef>
+#include <mutable/mutable.hpp>
+#include <mutable/storage/DataLayoutFactory.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+///> the number of tuples whose accesses are enumerated to estimate the bytes a scan touches
+constexpr std::size_t LAYOUT_ADVISOR_SAMPLE_TUPLES = 1UL << 16;
+///> the granularity of memory accesses, in bytes
+constexpr std::size_t LAYOUT_ADVISOR_CACHE_LINE_SIZE = 64;
+
+/** Estimates the bytes a scan of \p num_tuples tuples in layout \p layout touches, if the scan reads the attributes
+ * flagged in \p accessed, indexed like the attributes of the layout.  The NULL bitmap, the leaf following the
+ * attributes, is read whenever any attribute is.  The estimate counts the distinct cache lines that hold a value of an
+ * accessed attribute, using the offsets and strides of the layout, of the first `LAYOUT_ADVISOR_SAMPLE_TUPLES` tuples
+ * and extrapolates to \p num_tuples. */
+double estimate_bytes_touched(const m::storage::DataLayout &layout, const std::vector<bool> &accessed,
+                              std::size_t num_tuples);
+
+/** The estimated cost of a candidate layout for a workload. */
+struct layout_cost
+{
+    std::string name; ///< the name of the layout
+    double bytes_touched; ///< the estimated bytes touched by all queries of the workload
+};
+
+/** The layouts advised for a table. */
+struct layout_advice
+{
+    std::size_t best; ///< the index of the cheapest layout in `costs`
+    std::vector<layout_cost> costs; ///< the costs of all candidate layouts, in the order of the candidates
+
+    const layout_cost & choice() const { return costs[best]; }
+};
+
+/** Advises one of the \p candidates, pairs of a name and a layout factory, for table \p table with the attributes \p
+ * attributes of types \p types and \p num_tuples tuples.  Every candidate is made for the table, and the bytes touched
+ * by the scans of the queries of \p workload that reference the table are summed up with `estimate_bytes_touched()`.
+ * The cheapest candidate, the first one on ties, is advised.  The candidates must not be empty. */
+layout_advice advise_layout(const std::vector<std::pair<std::string, const m::storage::DataLayoutFactory*>> &candidates,
+                            const std::vector<workload_query> &workload, const std::string &table,
+                            const std::vector<std::string> &attributes, const std::vector<const m::Type*> &types,
+                            std::size_t num_tuples);
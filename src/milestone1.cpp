@@ -1,20 +1,31 @@
 #include "data_layouts.hpp"
+#include "layout_advisor.hpp"
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutable/mutable.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 int main(int argc, const char **argv)
 {
     /* Check the number of parameters. */
     if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <Layout> <CSV-File> <SQL-File>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <Layout> <CSV-File> <SQL-File>\n"
+                  << "\n"
+                  << "With Layout `auto`, the layout advisor picks the layout that touches the fewest bytes for the\n"
+                  << "queries of SQL-File." << std::endl;
         exit(EXIT_FAILURE);
     }
 
@@ -27,29 +38,91 @@ int main(int argc, const char **argv)
     /* Register our store(s) and set the default store. */
     C.register_data_layout("row_naive", std::make_unique<MyNaiveRowLayoutFactory>(), "row layout (naïve)");
     C.register_data_layout("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>(), "row layout (optimized)");
+    C.register_data_layout("row_out_of_line", std::make_unique<MyOutOfLineRowLayoutFactory>(),
+                           "row layout with wide character sequences out of line");
     C.register_data_layout("PAX4k", std::make_unique<MyPAX4kLayoutFactory>(), "PAX layout with 4KiB blocks");
-
-    /* Set default data layout. */
-    C.default_data_layout(argv[1]);
+    C.register_data_layout("PAX1k", std::make_unique<MyPAXLayoutFactory>(1024), "PAX layout with 1KiB blocks");
+    C.register_data_layout("PAX16k", std::make_unique<MyPAXLayoutFactory>(16 * 1024), "PAX layout with 16KiB blocks");
+    C.register_data_layout("PAX64k", std::make_unique<MyPAXLayoutFactory>(64 * 1024), "PAX layout with 64KiB blocks");
+    C.register_data_layout("PAX1M", std::make_unique<MyPAXLayoutFactory>(1024 * 1024), "PAX layout with 1MiB blocks");
+    C.register_data_layout("PAXauto", std::make_unique<MyPAXLayoutFactory>(MyPAXLayoutFactory::AUTO),
+                           "PAX layout with blocks of the size of the L2 cache");
+    C.register_data_layout("PAX4k_aligned", std::make_unique<MyPAXLayoutFactory>(4096, /* aligned = */ true),
+                           "PAX layout with 4KiB blocks and cache line aligned minipages");
+    C.register_data_layout("PAXhuge", std::make_unique<MyHugePagePAXLayoutFactory>(),
+                           "PAX layout with 4KiB blocks in 2MiB huge pages");
+    C.register_data_layout("columnar", std::make_unique<MyColumnarLayoutFactory>(), "columnar layout (DSM)");
 
     /* Create database 'dbsys' and select it. */
     auto &DB = C.add_database(C.pool("dbsys"));
     C.set_database_in_use(DB);
 
     /* Create table 'packages'. */
+    const std::pair<const char*, const m::Type*> attributes[] = {
+        { "id",          m::Type::Get_Integer(m::Type::TY_Vector, 4) },
+        { "repo",        m::Type::Get_Char(m::Type::TY_Vector, 10) },
+        { "pkg_name",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+        { "pkg_ver",     m::Type::Get_Char(m::Type::TY_Vector, 20) },
+        { "description", m::Type::Get_Char(m::Type::TY_Vector, 80) },
+        { "licenses",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+        { "size",        m::Type::Get_Integer(m::Type::TY_Vector, 8) },
+        { "packager",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+    };
     auto &T = DB.add_table(C.pool("packages"));
-    T.push_back(C.pool("id"),           m::Type::Get_Integer(m::Type::TY_Vector, 4));
-    T.push_back(C.pool("repo"),         m::Type::Get_Char(m::Type::TY_Vector, 10));
-    T.push_back(C.pool("pkg_name"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
-    T.push_back(C.pool("pkg_ver"),      m::Type::Get_Char(m::Type::TY_Vector, 20));
-    T.push_back(C.pool("description"),  m::Type::Get_Char(m::Type::TY_Vector, 80));
-    T.push_back(C.pool("licenses"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
-    T.push_back(C.pool("size"),         m::Type::Get_Integer(m::Type::TY_Vector, 8));
-    T.push_back(C.pool("packager"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
+    std::vector<std::string> attribute_names;
+    for (auto [name, type] : attributes) {
+        T.push_back(C.pool(name), type);
+        attribute_names.emplace_back(name);
+    }
+
+    /* Register the column groups of table 'packages' that the queries of the SQL file access together. */
+    std::vector<workload_query> workload;
+    try {
+        workload = parse_workload_files({ argv[3] });
+    } catch (std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    C.register_data_layout("column_groups", std::make_unique<MyColumnGroupLayoutFactory>(
+                               MyColumnGroupLayoutFactory::FromWorkload(workload, "packages", attribute_names)),
+                           "column groups of the attributes accessed together by the queries of the SQL file");
 
     /* Back the table with a store and set the data layout. */
     T.store(C.create_store(T));
-    T.layout(C.data_layout());
+    const bool advise = std::strcmp(argv[1], "auto") == 0;
+    if (advise) {
+        /* Count the rows of the CSV file, without the header, to make the layouts for the size of the table. */
+        std::ifstream csv(argv[2]);
+        if (not csv) {
+            std::cerr << "Cannot read CSV file '" << argv[2] << "'" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        const std::size_t num_rows = std::count(std::istreambuf_iterator<char>(csv), std::istreambuf_iterator<char>(),
+                                                '\n');
+        const std::size_t num_tuples = num_rows ? num_rows - 1 : 0;
+
+        /* Pick the layout with the fewest bytes touched by the queries. */
+        std::vector<const m::Type*> types;
+        for (auto [name, type] : attributes)
+            types.push_back(type);
+        std::vector<std::pair<std::string, const m::storage::DataLayoutFactory*>> candidates;
+        for (const char *name : { "row_naive", "row_optimized", "row_out_of_line", "PAX4k", "PAX1k", "PAX16k",
+                                  "PAX64k", "PAX1M", "PAXauto", "PAX4k_aligned", "PAXhuge", "columnar",
+                                  "column_groups" })
+            candidates.emplace_back(name, &C.data_layout(name));
+        const auto advice = advise_layout(candidates, workload, "packages", attribute_names, types, num_tuples);
+        for (auto &cost : advice.costs)
+            std::cerr << "Layout " << cost.name << ": " << cost.bytes_touched / (1024 * 1024)
+                      << " MiB expected to be touched by the queries.\n";
+        std::cerr << "Chose layout " << advice.choice().name << " for table 'packages'." << std::endl;
+
+        C.default_data_layout(advice.choice().name.c_str());
+        T.layout(C.data_layout().make(T.schema(), num_tuples));
+    } else {
+        /* Set default data layout. */
+        C.default_data_layout(argv[1]);
+        T.layout(C.data_layout());
+    }
 
     /* Load CSV file into table 'T'. */
     m::load_from_CSV(diag, T, argv[2], std::numeric_limits<std::size_t>::max(), true, false);
@@ -58,7 +131,13 @@ int main(int argc, const char **argv)
         exit(EXIT_FAILURE);
 
     /* Process the SQL file. */
+    const auto t_execute_begin = std::chrono::steady_clock::now();
     m::execute_file(diag, argv[3]);
+    const auto t_execute_end = std::chrono::steady_clock::now();
+    if (advise)
+        std::cerr << "Executed the queries in "
+                  << std::chrono::duration<double, std::milli>(t_execute_end - t_execute_begin).count() << " ms."
+                  << std::endl;
 
     m::Catalog::Destroy();
     exit(EXIT_SUCCESS);
@@ -1,27 +1,35 @@
 #include "BTree.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include <mutable/mutable.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <unistd.h>
+#include <vector>
 
 
 constexpr std::size_t NODE_SIZE = 4096;
 
-int main(int argc, char **argv)
-{
-    /* Check the number of parameters. */
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <CSV-File> <SIZE-MIN> <SIZE-MAX>" << std::endl;
-        exit(EXIT_FAILURE);
-    }
+using tree_type = BTree<int64_t, int32_t, NODE_SIZE>;
+using pair_type = std::pair<int64_t, int32_t>;
 
-    const int64_t size_min = strtol(argv[2], nullptr, 10);
-    const int64_t size_max = strtol(argv[3], nullptr, 10);
+///> identifies an index file written by `save_index()`
+constexpr char INDEX_MAGIC[8] = { 'D', 'B', 'S', '2', '2', 'I', 'D', 'X' };
+///> the number of buckets of the histogram written with `--histogram`
+constexpr std::size_t NUM_HISTOGRAM_BUCKETS = 64;
 
-    if (size_min > size_max) {
-        std::cerr << "SIZE-MIN must not be greater than SIZE-MAX" << std::endl;
-        exit(EXIT_FAILURE);
-    }
 
+/** Loads the CSV file \p filename into table 'packages' and returns all (size,id) pairs of the table, unsorted. */
+std::vector<pair_type> load_pairs_from_CSV(const char *filename)
+{
     /* Get a handle on the catalog. */
     auto &C = m::Catalog::Get();
 
@@ -48,13 +56,13 @@ int main(int argc, char **argv)
     T.layout(C.data_layout().make(T.schema()));
 
     /* Load CSV file into table 'T'. */
-    m::load_from_CSV(diag, T, argv[1], std::numeric_limits<std::size_t>::max(), true, false);
+    m::load_from_CSV(diag, T, filename, std::numeric_limits<std::size_t>::max(), true, false);
 
     if (diag.num_errors())
         exit(EXIT_FAILURE);
 
     /* Collect all (size,id) pairs. */
-    std::vector<std::pair<int64_t, int32_t>> size2id;
+    std::vector<pair_type> size2id;
 
     /* Query the table for all package sizes. */
     auto stmt = m::statement_from_string(diag, "SELECT size, id FROM packages;");
@@ -68,14 +76,266 @@ int main(int argc, char **argv)
     });
     m::execute_query(diag, *query, std::move(callback));
 
-    /* Sort all (size,id) pairs by size. */
-    std::sort(size2id.begin(), size2id.end(), [](auto left, auto right) { return left.first < right.first; });
+    return size2id;
+}
+
+/** Writes the (size,id) pairs of \p tree, in key order, to the index file \p filename.  Returns `true` on success.
+ *
+ * The file holds `INDEX_MAGIC`, the number of pairs as `uint64_t`, and the sizes followed by the ids, each as a
+ * contiguous array in native byte order.  Since the pairs are sorted, loading the file only bulkloads the tree, which
+ * is a single sequential pass, instead of parsing the CSV file, querying the table, and sorting. */
+bool save_index(const tree_type &tree, const char *filename)
+{
+    std::vector<int64_t> sizes;
+    std::vector<int32_t> ids;
+    sizes.reserve(tree.size());
+    ids.reserve(tree.size());
+    for (auto elem : tree) {
+        sizes.push_back(elem.first());
+        ids.push_back(elem.second());
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    const uint64_t num_pairs = tree.size();
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    out.write(reinterpret_cast<const char*>(&num_pairs), sizeof(num_pairs));
+    out.write(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(int64_t));
+    out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int32_t));
+    return bool(out);
+}
+
+/** Reads the sorted (size,id) pairs from the index file \p filename, written by `save_index()`, into \p pairs.
+ * Returns `true` on success. */
+bool load_index(const char *filename, std::vector<pair_type> &pairs)
+{
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(INDEX_MAGIC)];
+    uint64_t num_pairs;
+    if (not in.read(magic, sizeof(magic)) or std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) return false;
+    if (not in.read(reinterpret_cast<char*>(&num_pairs), sizeof(num_pairs))) return false;
+
+    /* Reject a truncated or corrupt file before allocating memory for the pairs it claims to hold. */
+    const std::streampos data_begin = in.tellg();
+    if (not in.seekg(0, std::ios::end)) return false;
+    const uint64_t data_size = uint64_t(in.tellg() - data_begin);
+    if (num_pairs > data_size / (sizeof(int64_t) + sizeof(int32_t))) return false;
+    in.seekg(data_begin);
+
+    std::vector<int64_t> sizes(num_pairs);
+    std::vector<int32_t> ids(num_pairs);
+    in.read(reinterpret_cast<char*>(sizes.data()), num_pairs * sizeof(int64_t));
+    in.read(reinterpret_cast<char*>(ids.data()), num_pairs * sizeof(int32_t));
+    if (not in) return false;
+
+    pairs.clear();
+    pairs.reserve(num_pairs);
+    for (uint64_t i = 0; i != num_pairs; ++i)
+        pairs.emplace_back(sizes[i], ids[i]);
+    return std::is_sorted(pairs.begin(), pairs.end(), [](auto &l, auto &r) { return l.first < r.first; });
+}
+
+/** Collects output in a large buffer and writes it to a `FILE` in batches, instead of formatting and writing every
+ * result line through `std::cout`. */
+struct output_buffer
+{
+    private:
+    static constexpr std::size_t CAPACITY = 1UL << 20;
+
+    std::FILE *out_;
+    std::unique_ptr<char[]> buffer_;
+    std::size_t size_ = 0;
+
+    public:
+    explicit output_buffer(std::FILE *out) : out_(out), buffer_(new char[CAPACITY]) { }
+    ~output_buffer() { flush(); }
+
+    void append(std::string_view str) {
+        if (size_ + str.size() > CAPACITY) flush();
+        if (str.size() > CAPACITY) {
+            std::fwrite(str.data(), 1, str.size(), out_);
+            return;
+        }
+        std::memcpy(buffer_.get() + size_, str.data(), str.size());
+        size_ += str.size();
+    }
+
+    void append(int64_t value) {
+        constexpr std::size_t MAX_DIGITS = 20; // sign and 19 digits
+        if (size_ + MAX_DIGITS > CAPACITY) flush();
+        auto [end, ec] = std::to_chars(buffer_.get() + size_, buffer_.get() + CAPACITY, value);
+        size_ = end - buffer_.get();
+    }
+
+    /** Writes the buffered output. */
+    void flush() {
+        std::fwrite(buffer_.get(), 1, size_, out_);
+        size_ = 0;
+    }
+};
+
+/** Parses a query of the form `SIZE-MIN SIZE-MAX` from \p line.  Returns `true` on success. */
+bool parse_query(std::string_view line, int64_t &size_min, int64_t &size_max)
+{
+    const char *p = line.data(), *end = line.data() + line.size();
+    auto skip_blanks = [&]() { while (p != end and (*p == ' ' or *p == '\t' or *p == '\r')) ++p; };
+    skip_blanks();
+    auto r = std::from_chars(p, end, size_min);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    skip_blanks();
+    r = std::from_chars(p, end, size_max);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    skip_blanks();
+    return p == end;
+}
+
+/** Answers the range query for packages with a size in `[size_min, size_max)` and appends the result to \p out. */
+void answer_query(const tree_type &tree, int64_t size_min, int64_t size_max, output_buffer &out)
+{
+    for (auto elem : tree.find_range(size_min, size_max)) {
+        out.append("Package with id ");
+        out.append(int64_t(elem.second()));
+        out.append(" is ");
+        out.append(int64_t(elem.first()));
+        out.append(" bytes.\n");
+    }
+}
 
-    /* Bulkload the sorted (size,id) pairs into a B+-tree. */
-    using tree_type = BTree<int64_t, int32_t, NODE_SIZE>;
-    auto btree = tree_type::Bulkload(size2id.cbegin(), size2id.cend());
+/** Prints the percentiles of the per-query \p latencies, in microseconds, to `std::cerr`. */
+void report_latencies(std::vector<double> &latencies)
+{
+    if (latencies.empty()) return;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min<std::size_t>(latencies.size() - 1, std::ceil(p / 100 * latencies.size()) - 1)];
+    };
+    std::cerr << "Answered " << latencies.size() << " queries; latency in us: p50 " << percentile(50)
+              << ", p90 " << percentile(90)
+              << ", p99 " << percentile(99)
+              << ", p99.9 " << percentile(99.9)
+              << ", max " << latencies.back() << std::endl;
+}
+
+void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " <CSV-File> <SIZE-MIN> <SIZE-MAX>\n"
+              << "       " << name << " (--csv <CSV-File> | --load <INDEX-File>) [--save <INDEX-File>]"
+                                      " [--queries <QUERY-File>]\n"
+              << "       " << std::string(std::strlen(name), ' ') << " [--histogram <JSON-File>]\n"
+              << "\n"
+              << "The first form answers a single query.  The second form builds the index from a CSV file or\n"
+              << "loads it from an index file, optionally saves it, and then answers the queries in QUERY-File, or\n"
+              << "on stdin if none is given, one query `SIZE-MIN SIZE-MAX` per line.  Every query reports the\n"
+              << "packages with a size in [SIZE-MIN, SIZE-MAX).  With --histogram, an equi-depth histogram of the\n"
+              << "sizes is written to JSON-File in the format of the injected cardinalities." << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+    /* Parse the parameters. */
+    const char *csv_file = nullptr, *load_file = nullptr, *save_file = nullptr, *query_file = nullptr,
+               *histogram_file = nullptr;
+    int64_t size_min = 0, size_max = 0;
+    bool single_query = false;
+    if (argc == 4 and argv[1][0] != '-') {
+        csv_file = argv[1];
+        size_min = strtol(argv[2], nullptr, 10);
+        size_max = strtol(argv[3], nullptr, 10);
+        single_query = true;
+        if (size_min > size_max) {
+            std::cerr << "SIZE-MIN must not be greater than SIZE-MAX" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        for (int i = 1; i < argc; ++i) {
+            if (i + 1 == argc) usage(argv[0]);
+            if      (std::strcmp(argv[i], "--csv") == 0)       csv_file = argv[++i];
+            else if (std::strcmp(argv[i], "--load") == 0)      load_file = argv[++i];
+            else if (std::strcmp(argv[i], "--save") == 0)      save_file = argv[++i];
+            else if (std::strcmp(argv[i], "--queries") == 0)   query_file = argv[++i];
+            else if (std::strcmp(argv[i], "--histogram") == 0) histogram_file = argv[++i];
+            else usage(argv[0]);
+        }
+        if ((csv_file == nullptr) == (load_file == nullptr)) usage(argv[0]);
+    }
+
+    /* Build the index once, either from the CSV file or from an index file. */
+    std::vector<pair_type> size2id;
+    std::unique_ptr<tree_type> btree;
+    if (csv_file) {
+        size2id = load_pairs_from_CSV(csv_file);
+        /* Sort all (size,id) pairs by size and bulkload them into a B+-tree. */
+        tree_type::bulkload_times times;
+        btree.reset(new tree_type(tree_type::BulkloadUnsorted(size2id.begin(), size2id.end(),
+                                                              std::thread::hardware_concurrency(), &times)));
+        std::cerr << "Sorted " << size2id.size() << " pairs in " << times.sort_ms << " ms, built the B+-tree in "
+                  << times.build_ms << " ms." << std::endl;
+    } else {
+        const auto t_load_begin = std::chrono::steady_clock::now();
+        if (not load_index(load_file, size2id)) {
+            std::cerr << "Cannot read index file '" << load_file << "'" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        btree.reset(new tree_type(tree_type::Bulkload(size2id.cbegin(), size2id.cend())));
+        const auto t_load_end = std::chrono::steady_clock::now();
+        std::cerr << "Loaded " << size2id.size() << " pairs and built the B+-tree in "
+                  << std::chrono::duration<double, std::milli>(t_load_end - t_load_begin).count() << " ms."
+                  << std::endl;
+    }
+    size2id = std::vector<pair_type>(); // release the pairs, the tree has its own copy
+
+    if (save_file and not save_index(*btree, save_file)) {
+        std::cerr << "Cannot write index file '" << save_file << "'" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (histogram_file) {
+        std::ofstream histogram_out(histogram_file);
+        write_cardinalities_json(histogram_out, "dbsys22", "packages", "size",
+                                 btree->histogram(NUM_HISTOGRAM_BUCKETS));
+        if (not histogram_out) {
+            std::cerr << "Cannot write histogram file '" << histogram_file << "'" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    output_buffer out(stdout);
+    if (single_query) {
+        /* Query the B+-tree for packages with a size between SIZE-MIN and SIZE-MAX. */
+        answer_query(*btree, size_min, size_max, out);
+        return 0;
+    }
+
+    /* Answer the stream of queries, one per line. */
+    std::ifstream query_in;
+    if (query_file) {
+        query_in.open(query_file);
+        if (not query_in) {
+            std::cerr << "Cannot read query file '" << query_file << "'" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    std::istream &in = query_file ? query_in : std::cin;
+    const bool interactive = not query_file and isatty(fileno(stdin));
+
+    std::vector<double> latencies;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() or line[0] == '#') continue;
+        if (not parse_query(line, size_min, size_max)) {
+            std::cerr << "Malformed query '" << line << "', expected 'SIZE-MIN SIZE-MAX'" << std::endl;
+            continue;
+        }
+        const auto t_query_begin = std::chrono::steady_clock::now();
+        answer_query(*btree, size_min, size_max, out);
+        const auto t_query_end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(t_query_end - t_query_begin).count());
+        if (interactive) out.flush(); // answer immediately when a user types queries
+    }
+    out.flush();
+    std::fflush(stdout);
 
-    /* Query the B+-tree for packages with a size between SIZE-MIN and SIZE-MAX. */
-    for (auto elem : btree.find_range(size_min, size_max))
-        std::cout << "Package with id " << elem.second() << " is " << elem.first() << " bytes.\n";
+    report_latencies(latencies);
 }
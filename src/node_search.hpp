@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+/* Search policies for locating a key within the sorted keys of a single tree node.  Every policy provides
+ *
+ *     static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key);
+ *     static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key);
+ *
+ * returning the index of the first of the \p n sorted \p keys that is not less than, respectively greater than, \p key,
+ * and \p n if there is no such key.  Every policy is a template on a `Counter` whose static `count()` is called for
+ * every key comparison, where a SIMD comparison of a vector of keys counts as one comparison.  The default counter
+ * `no_counter` does nothing and is compiled away; a counting variant of a policy is obtained by
+ * `Search::template with_counter<Counter>`. */
+
+
+/** Counts no comparisons. */
+struct no_counter
+{
+    static void count() { }
+};
+
+/** Compares keys with `<` and counts every comparison with \p Counter. */
+template<typename Counter>
+struct counting_less
+{
+    template<typename Key>
+    bool operator()(const Key &lhs, const Key &rhs) const {
+        Counter::count();
+        return lhs < rhs;
+    }
+};
+
+
+/** Scans the keys from left to right and stops at the first match. */
+template<typename Counter = no_counter>
+struct basic_linear_search
+{
+    template<typename C>
+    using with_counter = basic_linear_search<C>;
+
+    template<typename Key>
+    static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key) {
+        const counting_less<Counter> less;
+        std::size_t i = 0;
+        while (i < n and less(keys[i], key))
+            ++i;
+        return i;
+    }
+
+    template<typename Key>
+    static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key) {
+        const counting_less<Counter> less;
+        std::size_t i = 0;
+        while (i < n and not less(key, keys[i]))
+            ++i;
+        return i;
+    }
+};
+using linear_search = basic_linear_search<>;
+
+/** Bisects the keys. */
+template<typename Counter = no_counter>
+struct basic_binary_search
+{
+    template<typename C>
+    using with_counter = basic_binary_search<C>;
+
+    template<typename Key>
+    static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key) {
+        return std::lower_bound(keys, keys + n, key, counting_less<Counter>{}) - keys;
+    }
+
+    template<typename Key>
+    static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key) {
+        return std::upper_bound(keys, keys + n, key, counting_less<Counter>{}) - keys;
+    }
+};
+using binary_search = basic_binary_search<>;
+
+/** Scans the keys from left to right, comparing an entire SIMD vector of keys at once, and stops at the first vector
+ * that is not entirely less than (respectively, not greater than) the searched key.  Uses AVX2 for signed 32 and 64 bit
+ * integer keys and falls back to `linear_search` otherwise. */
+template<typename Counter = no_counter>
+struct basic_simd_search
+{
+    template<typename C>
+    using with_counter = basic_simd_search<C>;
+
+    template<typename Key>
+    static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key) {
+        return search<false>(keys, n, key);
+    }
+
+    template<typename Key>
+    static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key) {
+        return search<true>(keys, n, key);
+    }
+
+    private:
+    template<bool Upper, typename Key>
+    static std::size_t search(const Key *keys, std::size_t n, const Key &key) {
+        std::size_t i = 0;
+#ifdef __AVX2__
+        if constexpr (std::signed_integral<Key> and (sizeof(Key) == 4 or sizeof(Key) == 8)) {
+            constexpr std::size_t LANES = 32 / sizeof(Key);
+            constexpr unsigned ALL = (1U << LANES) - 1;
+            __m256i vkey;
+            if constexpr (sizeof(Key) == 4)
+                vkey = _mm256_set1_epi32(key);
+            else
+                vkey = _mm256_set1_epi64x(key);
+            for (; i + LANES <= n; i += LANES) {
+                Counter::count();
+                const __m256i vkeys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                /* Set a bit for every key that is less than (respectively, not greater than) the searched key. */
+                unsigned mask;
+                if constexpr (sizeof(Key) == 4) {
+                    mask = Upper ? ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vkeys, vkey)))
+                                 :  _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vkey, vkeys)));
+                } else {
+                    mask = Upper ? ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vkeys, vkey)))
+                                 :  _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vkey, vkeys)));
+                }
+                mask &= ALL;
+                if (mask != ALL)
+                    return i + std::popcount(mask);
+            }
+        }
+#endif
+        const std::size_t offset = i;
+        using linear = basic_linear_search<Counter>;
+        return offset + (Upper ? linear::upper_bound(keys + offset, n - offset, key)
+                               : linear::lower_bound(keys + offset, n - offset, key));
+    }
+};
+using simd_search = basic_simd_search<>;
+
+/** Guesses the position of the key by linear interpolation between the smallest and the largest key and scans a
+ * window of `WINDOW` keys around the guess with `simd_search`.  If the searched position lies outside of that window,
+ * i.e. the keys of the node are skewed, falls back to `binary_search` on the remaining keys.  Requires arithmetic keys;
+ * other keys are searched with `binary_search`. */
+template<typename Counter = no_counter>
+struct basic_interpolation_search
+{
+    template<typename C>
+    using with_counter = basic_interpolation_search<C>;
+
+    ///> the number of keys scanned next to the interpolated position before falling back to bisection
+    static constexpr std::size_t WINDOW = 16;
+
+    template<typename Key>
+    static std::size_t lower_bound(const Key *keys, std::size_t n, const Key &key) {
+        return search<false>(keys, n, key);
+    }
+
+    template<typename Key>
+    static std::size_t upper_bound(const Key *keys, std::size_t n, const Key &key) {
+        return search<true>(keys, n, key);
+    }
+
+    private:
+    template<bool Upper, typename Key>
+    static std::size_t search(const Key *keys, std::size_t n, const Key &key) {
+        using binary = basic_binary_search<Counter>;
+        if constexpr (not std::is_arithmetic_v<Key>) {
+            return Upper ? binary::upper_bound(keys, n, key) : binary::lower_bound(keys, n, key);
+        } else {
+            using simd = basic_simd_search<Counter>;
+            const counting_less<Counter> less;
+            /* `before(x)` iff `x` is positioned before the searched position. */
+            auto before = [&key, &less](const Key &x) { return Upper ? not less(key, x) : less(x, key); };
+            auto bound = [](const Key *keys, std::size_t n, const Key &key) {
+                return Upper ? simd::upper_bound(keys, n, key) : simd::lower_bound(keys, n, key);
+            };
+
+            if (n == 0 or not before(keys[0])) return 0;
+            if (before(keys[n - 1])) return n;
+
+            /* Interpolate; `keys[0] < keys[n - 1]` holds here, hence the denominator is positive. */
+            const double fraction = (double(key) - double(keys[0])) / (double(keys[n - 1]) - double(keys[0]));
+            const std::size_t guess = std::min<std::size_t>(n - 1, std::max(0., fraction * (n - 1)));
+
+            if (before(keys[guess])) {
+                /* Scan to the right. */
+                const std::size_t begin = guess + 1;
+                const std::size_t end = std::min(n, begin + WINDOW);
+                if (end == n or not before(keys[end - 1]))
+                    return begin + bound(keys + begin, end - begin, key);
+                return end + (Upper ? binary::upper_bound(keys + end, n - end, key)
+                                    : binary::lower_bound(keys + end, n - end, key));
+            } else {
+                /* Scan to the left. */
+                const std::size_t begin = guess > WINDOW ? guess - WINDOW : 0;
+                if (begin == 0 or before(keys[begin - 1]))
+                    return begin + bound(keys + begin, guess - begin, key);
+                return Upper ? binary::upper_bound(keys, begin, key) : binary::lower_bound(keys, begin, key);
+            }
+        }
+    }
+};
+using interpolation_search = basic_interpolation_search<>;
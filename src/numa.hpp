@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#endif
+#endif
+
+
+/* Minimal support for NUMA machines on Linux, without depending on libnuma.  On other systems, or if the topology
+ * cannot be read from sysfs, the machine is treated as a single node with all CPUs, and pinning threads and binding
+ * memory are no-ops. */
+namespace numa {
+
+/** Parses a Linux CPU or node list, e.g. "0-3,8-11", and returns the listed numbers. */
+inline std::vector<unsigned> parse_list(const std::string &list)
+{
+    std::vector<unsigned> numbers;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() or range == "\n") continue;
+        const auto dash = range.find('-');
+        const unsigned first = std::stoul(range.substr(0, dash));
+        const unsigned last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned n = first; n <= last; ++n)
+            numbers.push_back(n);
+    }
+    return numbers;
+}
+
+/** The NUMA nodes of the machine and their CPUs. */
+struct topology
+{
+    std::vector<unsigned> nodes; ///< the ids of the online nodes
+    std::vector<std::vector<unsigned>> cpus; ///< the CPUs of every node, in the order of `nodes`
+    std::vector<std::size_t> node_of_cpu; ///< for every CPU, the index of its node in `nodes`
+
+    private:
+    topology() {
+        std::string line;
+        if (std::ifstream online("/sys/devices/system/node/online"); online and std::getline(online, line)) {
+            for (unsigned node : parse_list(line)) {
+                std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string cpus_line;
+                if (not std::getline(cpulist, cpus_line)) continue;
+                auto node_cpus = parse_list(cpus_line);
+                if (node_cpus.empty()) continue; // memory-only node
+                nodes.push_back(node);
+                cpus.push_back(std::move(node_cpus));
+            }
+        }
+        if (nodes.empty()) {
+            /* Fall back to a single node with all CPUs. */
+            nodes.push_back(0);
+            cpus.emplace_back();
+            for (unsigned cpu = 0; cpu != std::max(1U, std::thread::hardware_concurrency()); ++cpu)
+                cpus.back().push_back(cpu);
+        }
+        for (std::size_t i = 0; i != nodes.size(); ++i) {
+            for (unsigned cpu : cpus[i]) {
+                if (cpu >= node_of_cpu.size()) node_of_cpu.resize(cpu + 1, 0);
+                node_of_cpu[cpu] = i;
+            }
+        }
+    }
+
+    public:
+    /** Returns the topology of this machine, which is read once. */
+    static const topology & Get() {
+        static const topology the_topology;
+        return the_topology;
+    }
+
+    ///> returns the number of NUMA nodes with CPUs
+    std::size_t num_nodes() const { return nodes.size(); }
+
+    /** Returns the index of the node in `nodes` of the CPU the calling thread currently runs on. */
+    std::size_t current_node() const {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        if (cpu >= 0 and std::size_t(cpu) < node_of_cpu.size())
+            return node_of_cpu[cpu];
+#endif
+        return 0;
+    }
+};
+
+/** Restricts the calling thread to \p cpu.  Returns `true` on success. */
+inline bool pin_thread_to_cpu(unsigned cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+/** Restricts the calling thread to the CPUs of the node with index \p node in \p topo.  Returns `true` on success. */
+inline bool pin_thread_to_node(const topology &topo, std::size_t node)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : topo.cpus[node])
+        CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void) topo, (void) node;
+    return false;
+#endif
+}
+
+/** Makes all future memory allocations of the calling thread come from the node with id \p node_id, by setting the
+ * memory policy of the thread to `MPOL_BIND`.  Returns `true` on success.  If binding fails, e.g. because the kernel
+ * lacks NUMA support or the process may not change its policy, memory is still allocated on the node of the CPU that
+ * first touches it. */
+inline bool bind_memory_to_node(unsigned node_id)
+{
+#if defined(__linux__) && defined(SYS_set_mempolicy) && defined(MPOL_BIND)
+    constexpr std::size_t BITS = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node_id / BITS + 1, 0);
+    mask[node_id / BITS] |= 1UL << (node_id % BITS);
+    return syscall(SYS_set_mempolicy, MPOL_BIND, mask.data(), mask.size() * BITS + 1) == 0;
+#else
+    (void) node_id;
+    return false;
+#endif
+}
+
+/** Resets the memory policy of the calling thread to the default policy, i.e. allocation on the local node. */
+inline void reset_memory_policy()
+{
+#if defined(__linux__) && defined(SYS_set_mempolicy) && defined(MPOL_DEFAULT)
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+#endif
+}
+
+}
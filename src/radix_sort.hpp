@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+///> inputs with fewer elements are sorted by a single thread
+constexpr std::size_t RADIX_SORT_PARALLEL_THRESHOLD = 1UL << 16;
+///> inputs with fewer elements are sorted with `std::stable_sort`
+constexpr std::size_t RADIX_SORT_THRESHOLD = 256;
+
+namespace detail {
+
+/** Calls `fn(t, begin, end)` for every thread `t` of \p num_threads on the `t`-th of \p num_threads equally sized
+ * chunks of the index range `[0, n)`, in parallel. */
+template<typename Fn>
+void parallel_chunks(std::size_t n, std::size_t num_threads, Fn &&fn)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (std::size_t t = 1; t < num_threads; ++t)
+        threads.emplace_back([&fn, t, n, num_threads]() { fn(t, t * n / num_threads, (t + 1) * n / num_threads); });
+    fn(0, 0, n / num_threads); // the first chunk on the calling thread
+    for (auto &thread : threads)
+        thread.join();
+}
+
+}
+
+/** Sorts the elements in the range from \p begin to \p end stably by the integral key `key_of(element)`, using a
+ * least-significant-digit radix sort with 8 bit digits on \p num_threads threads.  Each pass computes a histogram of
+ * the digit per thread and chunk of the input, and scatters the chunks in parallel to disjoint positions of a scratch
+ * buffer of the size of the input; passes where all keys share the same digit are skipped.  The elements must be
+ * default-initializable and movable. */
+template<std::contiguous_iterator It, typename KeyOf>
+requires std::integral<std::decay_t<std::invoke_result_t<KeyOf, std::iter_reference_t<It>>>>
+void radix_sort(It begin, It end, KeyOf key_of, std::size_t num_threads = std::thread::hardware_concurrency())
+{
+    using value_type = std::iter_value_t<It>;
+    using key_type = std::decay_t<std::invoke_result_t<KeyOf, std::iter_reference_t<It>>>;
+    using unsigned_type = std::make_unsigned_t<key_type>;
+    constexpr std::size_t NUM_BUCKETS = 256;
+    constexpr std::size_t NUM_PASSES = sizeof(key_type);
+    /* Flip the sign bit of signed keys to order negative before positive keys. */
+    constexpr unsigned_type SIGN_FLIP = std::is_signed_v<key_type> ? unsigned_type(1) << (8 * sizeof(key_type) - 1) : 0;
+
+    const std::size_t n = std::distance(begin, end);
+    if (n < RADIX_SORT_THRESHOLD) {
+        std::stable_sort(begin, end, [&key_of](auto &l, auto &r) { return key_of(l) < key_of(r); });
+        return;
+    }
+    if (n < RADIX_SORT_PARALLEL_THRESHOLD or num_threads == 0) num_threads = 1;
+
+    std::vector<value_type> buffer(n);
+    value_type *src = std::to_address(begin);
+    value_type *dst = buffer.data();
+    std::vector<std::array<std::size_t, NUM_BUCKETS>> histograms(num_threads);
+
+    for (std::size_t pass = 0; pass != NUM_PASSES; ++pass) {
+        const std::size_t shift = 8 * pass;
+        auto digit = [&key_of, shift](const value_type &v) {
+            return ((unsigned_type(key_of(v)) ^ SIGN_FLIP) >> shift) & (NUM_BUCKETS - 1);
+        };
+
+        /* Count the digits per chunk. */
+        detail::parallel_chunks(n, num_threads, [&](std::size_t t, std::size_t first, std::size_t last) {
+            auto &histogram = histograms[t];
+            histogram.fill(0);
+            for (std::size_t i = first; i != last; ++i)
+                ++histogram[digit(src[i])];
+        });
+
+        /* Skip the pass if all keys share the same digit. */
+        const std::size_t d0 = digit(src[0]);
+        std::size_t count_d0 = 0;
+        for (auto &histogram : histograms)
+            count_d0 += histogram[d0];
+        if (count_d0 == n) continue;
+
+        /* Turn the counts into the first output position of every chunk and digit.  Positions are ordered by digit
+         * first and by chunk second, which makes the sort stable. */
+        std::size_t offset = 0;
+        for (std::size_t d = 0; d != NUM_BUCKETS; ++d) {
+            for (auto &histogram : histograms) {
+                const std::size_t count = histogram[d];
+                histogram[d] = offset;
+                offset += count;
+            }
+        }
+
+        /* Scatter the chunks. */
+        detail::parallel_chunks(n, num_threads, [&](std::size_t t, std::size_t first, std::size_t last) {
+            auto &positions = histograms[t];
+            for (std::size_t i = first; i != last; ++i)
+                dst[positions[digit(src[i])]++] = std::move(src[i]);
+        });
+        std::swap(src, dst);
+    }
+
+    /* Move the result back, if it ended in the scratch buffer. */
+    if (src != std::to_address(begin)) {
+        value_type *out = std::to_address(begin);
+        detail::parallel_chunks(n, num_threads, [&](std::size_t, std::size_t first, std::size_t last) {
+            std::move(src + first, src + last, out + first);
+        });
+    }
+}
+
+/** Sorts the elements in the range from \p begin to \p end by `key_of(element)`.  Integral keys are sorted stably with
+ * `radix_sort()` on \p num_threads threads, if the elements are stored contiguously, and all other keys with
+ * `std::stable_sort()`. */
+template<std::random_access_iterator It, typename KeyOf>
+void sort_by_key(It begin, It end, KeyOf key_of, std::size_t num_threads = std::thread::hardware_concurrency())
+{
+    using key_type = std::decay_t<std::invoke_result_t<KeyOf, std::iter_reference_t<It>>>;
+    if constexpr (std::integral<key_type> and std::contiguous_iterator<It> and
+                  std::default_initializable<std::iter_value_t<It>>)
+        radix_sort(begin, end, key_of, num_threads);
+    else
+        std::stable_sort(begin, end, [&key_of](auto &l, auto &r) { return key_of(l) < key_of(r); });
+}
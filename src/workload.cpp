@@ -0,0 +1,98 @@
+#include "workload.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+std::vector<bool> workload_query::accessed_attributes(const std::string &table,
+                                                      const std::vector<std::string> &attributes) const
+{
+    std::vector<bool> accessed(attributes.size(), false);
+    if (not references(table)) return accessed;
+    for (std::size_t idx = 0; idx != attributes.size(); ++idx)
+        accessed[idx] = selects_all or references(attributes[idx]);
+    return accessed;
+}
+
+std::vector<workload_query> parse_workload(std::istream &in)
+{
+    const std::string sql((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<workload_query> queries;
+    workload_query query;
+    std::string previous_token; // the previous token, to tell `SELECT *` and `T.*` from a multiplication
+
+    auto finish_statement = [&]() {
+        /* Trim the statement and drop it if empty. */
+        const auto first = query.sql.find_first_not_of(" \t\r\n");
+        if (first != std::string::npos) {
+            query.sql = query.sql.substr(first, query.sql.find_last_not_of(" \t\r\n") - first + 1);
+            queries.push_back(std::move(query));
+        }
+        query = workload_query();
+        previous_token.clear();
+    };
+
+    for (std::size_t pos = 0; pos < sql.size(); ) {
+        const char c = sql[pos];
+        if (c == ';') {
+            finish_statement();
+            ++pos;
+        } else if (c == '-' and pos + 1 < sql.size() and sql[pos + 1] == '-') {
+            /* Skip the comment until the end of the line. */
+            pos = std::min(sql.find('\n', pos), sql.size());
+        } else if (c == '"' or c == '\'') {
+            /* Skip the string literal, including escaped quotes. */
+            std::size_t end = pos + 1;
+            while (end < sql.size() and sql[end] != c)
+                end += sql[end] == '\\' ? 2 : 1;
+            end = std::min(end + 1, sql.size());
+            query.sql.append(sql, pos, end - pos);
+            previous_token = "literal";
+            pos = end;
+        } else if (std::isalpha(static_cast<unsigned char>(c)) or c == '_') {
+            std::size_t end = pos + 1;
+            while (end < sql.size() and (std::isalnum(static_cast<unsigned char>(sql[end])) or sql[end] == '_'))
+                ++end;
+            previous_token = sql.substr(pos, end - pos);
+            query.identifiers.insert(previous_token);
+            query.sql.append(previous_token);
+            pos = end;
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            /* Skip the number, including a decimal point and a suffix. */
+            std::size_t end = pos + 1;
+            while (end < sql.size() and (std::isalnum(static_cast<unsigned char>(sql[end])) or sql[end] == '.'))
+                ++end;
+            query.sql.append(sql, pos, end - pos);
+            previous_token = "number";
+            pos = end;
+        } else {
+            if (c == '*') {
+                std::string upper(previous_token);
+                std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) {
+                    return std::toupper(c);
+                });
+                if (upper == "SELECT" or upper == "DISTINCT" or previous_token == "," or previous_token == ".")
+                    query.selects_all = true;
+            }
+            if (not std::isspace(static_cast<unsigned char>(c))) previous_token = std::string(1, c);
+            query.sql.push_back(c);
+            ++pos;
+        }
+    }
+    finish_statement();
+    return queries;
+}
+
+std::vector<workload_query> parse_workload_files(const std::vector<std::string> &filenames)
+{
+    std::vector<workload_query> queries;
+    for (const std::string &filename : filenames) {
+        std::ifstream in(filename);
+        if (not in) throw std::runtime_error("cannot read workload file '" + filename + "'");
+        auto file_queries = parse_workload(in);
+        std::move(file_queries.begin(), file_queries.end(), std::back_inserter(queries));
+    }
+    return queries;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+/** A statement of a SQL workload, reduced to the identifiers it references.  The statement is not parsed: every
+ * identifier outside of string literals and comments counts as a reference, which over-approximates the attributes
+ * a query accesses, e.g. for a keyword that coincides with an attribute name, but never misses one. */
+struct workload_query
+{
+    std::string sql; ///< the text of the statement, without the terminating `;`
+    std::unordered_set<std::string> identifiers; ///< the identifiers referenced by the statement
+    bool selects_all = false; ///< whether the statement selects `*`, i.e. all attributes
+
+    ///> returns `true` iff the statement references the identifier \p name
+    bool references(const std::string &name) const { return identifiers.count(name); }
+
+    /** Returns, for every attribute of \p attributes of table \p table, whether the statement accesses it.  If the
+     * statement does not reference \p table, it accesses no attribute of it. */
+    std::vector<bool> accessed_attributes(const std::string &table, const std::vector<std::string> &attributes) const;
+};
+
+/** Splits the SQL text read from \p in into statements at every `;` and collects the identifiers of every statement.
+ * Empty statements are dropped. */
+std::vector<workload_query> parse_workload(std::istream &in);
+
+/** Reads the SQL workload from each of the files \p filenames with `parse_workload()`.  Throws `std::runtime_error` if
+ * a file cannot be read. */
+std::vector<workload_query> parse_workload_files(const std::vector<std::string> &filenames);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mutable/util/macro.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/** A zone map of a column, i.e. the smallest and largest value of every block of a fixed number of consecutive rows,
+ * e.g. of a PAX block or of a chunk of a row layout.  The zone map is maintained by the writer, which appends every
+ * value of the column in row order, and consulted by scans to skip blocks that cannot hold a qualifying row.  Skipping
+ * pays off if the column is clustered, e.g. sorted or growing with the insertion order.
+ *
+ * @tparam T  the type of the values, a numeric type or a fixed-width character sequence like `std::array<char, N>` */
+template<typename T>
+struct zone_map
+{
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /** The smallest and largest value of a block. */
+    struct zone
+    {
+        value_type min;
+        value_type max;
+    };
+
+    private:
+    size_type num_tuples_per_block_;
+    std::vector<zone> zones_;
+    size_type num_tuples_ = 0;
+
+    public:
+    /** Creates an empty zone map of blocks of \p num_tuples_per_block rows. */
+    explicit zone_map(size_type num_tuples_per_block) : num_tuples_per_block_(num_tuples_per_block) {
+        M_insist(num_tuples_per_block > 0, "a block must hold a row");
+    }
+
+    ///> returns the number of rows per block
+    size_type num_tuples_per_block() const { return num_tuples_per_block_; }
+    ///> returns the number of rows
+    size_type size() const { return num_tuples_; }
+    ///> returns the number of blocks, including the last, partial block
+    size_type num_blocks() const { return zones_.size(); }
+    ///> returns the zone of every block
+    const std::vector<zone> & zones() const { return zones_; }
+    ///> returns the bytes of the zones
+    size_type size_in_bytes() const { return zones_.size() * sizeof(zone); }
+
+    /** Appends the value \p value of the next row. */
+    void append(const value_type &value) {
+        if (num_tuples_ % num_tuples_per_block_ == 0) {
+            zones_.push_back(zone{ value, value });
+        } else {
+            zone &z = zones_.back();
+            z.min = std::min(z.min, value);
+            z.max = std::max(z.max, value);
+        }
+        ++num_tuples_;
+    }
+
+    /** Returns `true` iff block \p block may hold a value in the closed range [\p lo, \p hi]. */
+    bool may_contain(size_type block, const value_type &lo, const value_type &hi) const {
+        const zone &z = zones_[block];
+        return not (z.max < lo or hi < z.min);
+    }
+
+    /** Calls \p fn with the first and one past the last row of every block whose zone satisfies \p may_qualify, a
+     * predicate on a `zone` that must be `true` if the block may hold a qualifying row.  Returns the number of skipped
+     * blocks. */
+    template<typename Pred, typename Fn>
+    size_type scan(Pred &&may_qualify, Fn &&fn) const {
+        size_type num_skipped = 0;
+        for (size_type block = 0; block != zones_.size(); ++block) {
+            if (not may_qualify(zones_[block])) {
+                ++num_skipped;
+                continue;
+            }
+            const size_type first = block * num_tuples_per_block_;
+            fn(first, std::min(first + num_tuples_per_block_, num_tuples_));
+        }
+        return num_skipped;
+    }
+
+    /** Calls \p fn with the first and one past the last row of every block that may hold a value in the closed range
+     * [\p lo, \p hi].  Returns the number of skipped blocks. */
+    template<typename Fn>
+    size_type scan(const value_type &lo, const value_type &hi, Fn &&fn) const {
+        return scan([&lo, &hi](const zone &z) { return not (z.max < lo or hi < z.min); }, std::forward<Fn>(fn));
+    }
+};
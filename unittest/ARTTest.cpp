@@ -0,0 +1,54 @@
+#include "catch2/catch.hpp"
+
+#include "ART.hpp"
+#include "IndexTest.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+using char8 = std::array<char, 8>;
+using char16 = std::array<char, 16>;
+
+template<typename key_type, typename value_type>
+void __test_art()
+{
+    using tree_type = ART<key_type, value_type>;
+    __test_lookup_index<tree_type>([](const tree_type &tree) { CHECK(tree.num_nodes() == 0); },
+                                   [](const tree_type &tree) { CHECK(tree.num_nodes() > 0); });
+}
+
+}
+
+
+TEST_CASE("ART/radix_key", "[milestone2]")
+{
+    auto encode = []<typename T>(T key) {
+        std::array<uint8_t, radix_key<T>::LENGTH> bytes;
+        radix_key<T>::encode(key, bytes.data());
+        return bytes;
+    };
+    CHECK(encode(int32_t(-1)) < encode(int32_t(0)));
+    CHECK(encode(int32_t(-200)) < encode(int32_t(-100)));
+    CHECK(encode(int64_t(255)) < encode(int64_t(256)));
+    CHECK(encode(uint16_t(1)) < encode(uint16_t(0xff00)));
+    CHECK(encode(char8{ 'a', 'b' }) < encode(char8{ 'a', 'b', 'c' }));
+    CHECK(encode(char8{ 'a', 'z' }) < encode(char8{ 'b' }));
+    CHECK((encode(char8{ '\x7f' }) < encode(char8{ '\x80' })) == (char8{ '\x7f' } < char8{ '\x80' }));
+}
+
+TEST_CASE("ART", "[milestone2]")
+{
+#define TEST(KEY, VALUE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE)) \
+    { __test_art<KEY, VALUE>(); }
+
+    TEST(int32_t, int32_t);
+    TEST(int64_t, int64_t);
+    TEST(char16, int32_t);
+
+#undef TEST
+}
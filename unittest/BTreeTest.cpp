@@ -1,7 +1,12 @@
 #include "catch2/catch.hpp"
 
 #include "BTree.hpp"
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <limits>
+#include <random>
+#include <sstream>
 #include <typeinfo>
 #include <vector>
 
@@ -119,10 +124,10 @@ void __test_bulkload()
     }
 }
 
-template<typename key_type, typename value_type, std::size_t node_size>
+template<typename key_type, typename value_type, std::size_t node_size, typename search = linear_search>
 void __test_find()
 {
-    using tree_type = BTree<key_type, value_type, node_size>;
+    using tree_type = BTree<key_type, value_type, node_size, node_size, search>;
     using pair_type = std::pair<key_type, value_type>;
 
     SECTION("empty")
@@ -261,10 +266,10 @@ void __test_find()
     }
 }
 
-template<typename key_type, typename value_type, std::size_t node_size>
+template<typename key_type, typename value_type, std::size_t node_size, typename search = linear_search>
 void __test_find_range()
 {
-    using tree_type = BTree<key_type, value_type, node_size>;
+    using tree_type = BTree<key_type, value_type, node_size, node_size, search>;
     using pair_type = std::pair<key_type, value_type>;
 
     SECTION("empty")
@@ -411,6 +416,23 @@ void __test_find_range()
             CHECK(it == range.end());
             CHECK(it == tree.end());
         }
+
+        /* The same queries on a `const` tree. */
+        const auto &ctree = tree;
+        CHECK(ctree.find_range(-100, 0).empty());
+        CHECK(ctree.find_range(100, 200).empty());
+        CHECK(ctree.find_range(42, 42).empty());
+        for (key_type key = 0; key != N; ++key) {
+            auto range = ctree.find_range(key, N);
+            auto it = range.begin();
+            REQUIRE(it != range.end());
+            CHECK((*it).first() == key);
+            key_type count = 0;
+            for (; it != range.end(); ++it)
+                ++count;
+            CHECK(count == N - key);
+            CHECK(range.end() == ctree.cend());
+        }
     }
 
     SECTION("N = 1e6")
@@ -443,10 +465,10 @@ void __test_find_range()
     }
 }
 
-template<typename key_type, typename value_type, std::size_t node_size>
+template<typename key_type, typename value_type, std::size_t node_size, typename search = linear_search>
 void __test_equal_range()
 {
-    using tree_type = BTree<key_type, value_type, node_size>;
+    using tree_type = BTree<key_type, value_type, node_size, node_size, search>;
     using pair_type = std::pair<key_type, value_type>;
 
     SECTION("empty")
@@ -681,22 +703,545 @@ void __test_equal_range()
     }
 }
 
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_parallel_scan()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    auto sum = [](uint64_t &acc, const key_type&, const value_type &value) { acc += value; };
+    auto combine = [](uint64_t left, uint64_t right) { return left + right; };
+
+    SECTION("empty")
+    {
+        std::array<pair_type, 0> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        CHECK(tree.partition_range(0, 42, 4).empty());
+        CHECK(tree.parallel_scan(0, 42, 4, uint64_t(0), sum, combine) == 0);
+    }
+
+    SECTION("N = 100'000")
+    {
+        constexpr key_type N = 100'000;
+        constexpr unsigned REP_COUNT = 3;
+        std::vector<pair_type> data;
+        data.reserve(N);
+        for (key_type key = 0; key != N / REP_COUNT; ++key) {
+            for (unsigned v = 0; v != REP_COUNT; ++v)
+                data.emplace_back(key, 2 * key + 13);
+        }
+
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        for (auto [lo, hi] : { std::pair<key_type, key_type>{ -10, N }, { 1000, 1001 }, { 42, 20'000 }, { 40, 30 } }) {
+            DYNAMIC_SECTION("[" << lo << ", " << hi << ")") {
+                uint64_t expected = 0;
+                for (auto &[key, value] : data) {
+                    if (lo <= key and key < hi)
+                        expected += value;
+                }
+
+                for (std::size_t num_threads : { 1, 2, 3, 8 }) {
+                    auto splits = tree.partition_range(lo, hi, num_threads);
+                    CHECK(splits.size() < num_threads);
+                    CHECK(std::is_sorted(splits.begin(), splits.end()));
+                    for (auto split : splits) {
+                        CHECK(lo < split);
+                        CHECK(split < hi);
+                    }
+
+                    CHECK(tree.parallel_scan(lo, hi, num_threads, uint64_t(0), sum, combine) == expected);
+                }
+            }
+        }
+    }
 }
 
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_bulkload_unsorted()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
 
-TEST_CASE("BTree/node size", "[milestone2]")
+    std::mt19937 g(42);
+    for (std::size_t n : { 0UL, 1UL, 100UL, 1000UL, 100000UL }) {
+        /* Draw keys with many duplicates and, for signed keys, negative keys.  Number the pairs in input order. */
+        std::uniform_int_distribution<key_type> dist(std::is_signed_v<key_type> ? -key_type(n) : 0, key_type(n));
+        std::vector<pair_type> data;
+        for (std::size_t i = 0; i != n; ++i)
+            data.emplace_back(dist(g), value_type(i));
+        auto expected = data;
+        std::stable_sort(expected.begin(), expected.end(), [](auto &l, auto &r) { return l.first < r.first; });
+
+        for (std::size_t num_threads : { 1, 4 }) {
+            auto unsorted = data;
+            typename tree_type::bulkload_times times;
+            auto tree = tree_type::BulkloadUnsorted(unsorted.begin(), unsorted.end(), num_threads, &times);
+
+            CHECK(unsorted == expected);
+            CHECK(times.sort_ms >= 0);
+            CHECK(times.build_ms >= 0);
+            REQUIRE(tree.size() == n);
+            std::vector<pair_type> contents;
+            for (auto p : tree)
+                contents.emplace_back(p.first(), p.second());
+            CHECK(contents == expected); // pairs with equal keys keep their order
+        }
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_insert()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    /* Checks that `tree` contains exactly the pairs of `expected`, in key order, and is well-formed. */
+    auto check = [](tree_type &tree, std::vector<pair_type> expected) {
+        std::sort(expected.begin(), expected.end());
+        REQUIRE(tree.size() == expected.size());
+
+        std::vector<pair_type> contents;
+        for (auto p : tree)
+            contents.emplace_back(p.first(), p.second());
+        REQUIRE(contents.size() == expected.size());
+        CHECK(std::is_sorted(contents.begin(), contents.end(), [](auto &l, auto &r) { return l.first < r.first; }));
+        std::sort(contents.begin(), contents.end()); // pairs with equal keys may be in any order
+        CHECK(contents == expected);
+
+        auto stats = tree.stats();
+        CHECK(stats.levels.size() == tree.height() + 1);
+        CHECK(stats.leaves().num_entries == expected.size());
+        for (std::size_t l = 0; l + 1 < stats.levels.size(); ++l)
+            CHECK(stats.levels[l].num_entries == stats.levels[l + 1].num_nodes);
+
+        for (auto &p : expected) {
+            auto it = tree.find(p.first);
+            REQUIRE(it != tree.end());
+            CHECK((*it).first() == p.first);
+        }
+        if (not expected.empty()) {
+            const key_type lo = expected[expected.size() / 4].first;
+            const key_type hi = expected[3 * expected.size() / 4].first;
+            std::size_t count = 0;
+            for (auto p : tree.find_range(lo, hi)) {
+                (void) p;
+                ++count;
+            }
+            CHECK(count == std::size_t(std::count_if(expected.begin(), expected.end(),
+                                                     [&](auto &p) { return lo <= p.first and p.first < hi; })));
+        }
+    };
+
+    std::mt19937 g(42);
+
+    SECTION("into empty tree")
+    {
+        std::vector<pair_type> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        std::uniform_int_distribution<key_type> dist(-1000, 1000); // many duplicates
+        for (std::size_t i = 0; i != 5000; ++i) {
+            data.emplace_back(dist(g), value_type(i));
+            tree.insert(data.back().first, data.back().second);
+        }
+        check(tree, data);
+    }
+
+    SECTION("ascending and descending")
+    {
+        std::vector<pair_type> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        for (key_type k = 0; k != 3000; ++k) {
+            data.emplace_back(k, value_type(k));
+            tree.insert(k, value_type(k));
+            data.emplace_back(-k - 1, value_type(k));
+            tree.insert(-k - 1, value_type(k));
+        }
+        check(tree, data);
+    }
+
+    for (double fill : { 1., .7, .5 }) {
+        DYNAMIC_SECTION("into bulkloaded tree with fill " << fill)
+        {
+            std::vector<pair_type> data;
+            for (key_type k = 0; k != 10000; ++k)
+                data.emplace_back(2 * k, value_type(k));
+            auto tree = tree_type::Bulkload(data.cbegin(), data.cend(), fill, fill);
+            check(tree, data);
+            std::uniform_int_distribution<key_type> dist(-10, 20010);
+            for (std::size_t i = 0; i != 5000; ++i) {
+                data.emplace_back(dist(g), value_type(i));
+                tree.insert(data.back().first, data.back().second);
+            }
+            check(tree, data);
+        }
+    }
+}
+
+/** Counts the key comparisons of a search policy. */
+struct comparison_counter
+{
+    static inline std::size_t num_comparisons = 0;
+    static void count() { ++num_comparisons; }
+};
+
+template<typename search, typename key_type>
+void __test_node_search()
 {
-    auto test = []<typename key_type, typename value_type, std::size_t node_size>() {
-        using tree_type = BTree<key_type, value_type, node_size>;
-        using INode = typename tree_type::INode;
-        using Leaf = typename tree_type::Leaf;
-        CHECK(sizeof(INode) <= node_size);
-        CHECK(sizeof(Leaf) <= node_size);
-        CHECK(alignof(INode) >= node_size);
-        CHECK(alignof(Leaf) >= node_size);
+    using counted_search = typename search::template with_counter<comparison_counter>;
+    std::mt19937 g(42);
+    std::vector<key_type> keys;
+
+    /* Checks the comparisons counted by `counted_search` for a search with result `i` against an instrumented
+     * reference search, respectively against the worst case of the policy. */
+    auto check_comparisons = [&](const key_type &key, bool upper, std::size_t i) {
+        const std::size_t n = keys.size();
+        const std::size_t num_comparisons = comparison_counter::num_comparisons;
+        if constexpr (std::is_same_v<search, linear_search>) {
+            CHECK(num_comparisons == std::min(i + 1, n));
+        } else if constexpr (std::is_same_v<search, binary_search>) {
+            std::size_t expected = 0;
+            auto less = [&expected](const key_type &lhs, const key_type &rhs) { ++expected; return lhs < rhs; };
+            if (upper)
+                (void) std::upper_bound(keys.begin(), keys.end(), key, less);
+            else
+                (void) std::lower_bound(keys.begin(), keys.end(), key, less);
+            CHECK(num_comparisons == expected);
+        } else if constexpr (std::is_same_v<search, simd_search>) {
+            /* A vector comparison covers at least one key. */
+            CHECK(num_comparisons <= std::min(i + 1, n));
+            CHECK((num_comparisons == 0) == (n == 0));
+        } else {
+            /* Both ends, the guess, and the end of the window, then either the window or a bisection. */
+            CHECK(num_comparisons <= 4 + std::max<std::size_t>(interpolation_search::WINDOW, std::bit_width(n)));
+            CHECK((num_comparisons == 0) == (n == 0));
+        }
     };
+
+    auto check = [&]() {
+        std::sort(keys.begin(), keys.end());
+        const key_type lo = keys.empty() ? 0 : keys.front() - 2;
+        const key_type hi = keys.empty() ? 0 : keys.back() + 2;
+        for (key_type key = lo; key <= hi; ++key) {
+            const std::size_t lower = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+            const std::size_t upper = std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+            CHECK(search::lower_bound(keys.data(), keys.size(), key) == lower);
+            CHECK(search::upper_bound(keys.data(), keys.size(), key) == upper);
+
+            /* Counting comparisons must not alter the search. */
+            comparison_counter::num_comparisons = 0;
+            CHECK(counted_search::lower_bound(keys.data(), keys.size(), key) == lower);
+            check_comparisons(key, false, lower);
+            comparison_counter::num_comparisons = 0;
+            CHECK(counted_search::upper_bound(keys.data(), keys.size(), key) == upper);
+            check_comparisons(key, true, upper);
+        }
+    };
+
+    SECTION("empty") { check(); }
+
+    SECTION("uniform")
+    {
+        std::uniform_int_distribution<key_type> dist(0, 1000);
+        for (unsigned n : { 1, 7, 8, 9, 64, 255 }) {
+            keys.clear();
+            for (unsigned i = 0; i != n; ++i) keys.push_back(dist(g));
+            check();
+        }
+    }
+
+    SECTION("skewed")
+    {
+        keys.clear();
+        for (key_type i = 0; i != 200; ++i) keys.push_back(i < 190 ? i / 8 : 1000 + i * i);
+        check();
+    }
+
+    SECTION("duplicates")
+    {
+        keys.assign(100, 42);
+        check();
+    }
+}
+
+template<typename key_type>
+void __test_radix_sort()
+{
+    std::mt19937 g(42);
+    auto key_of = [](auto &p) { return p.first; };
+    for (std::size_t n : { 0UL, 1UL, 255UL, 256UL, 10000UL, 100000UL }) {
+        for (key_type range : { key_type(1), key_type(100), std::numeric_limits<key_type>::max() }) {
+            std::uniform_int_distribution<key_type> dist(std::is_signed_v<key_type> ? -range : 0, range);
+            std::vector<std::pair<key_type, uint32_t>> data;
+            for (std::size_t i = 0; i != n; ++i)
+                data.emplace_back(dist(g), uint32_t(i));
+            auto expected = data;
+            std::stable_sort(expected.begin(), expected.end(), [](auto &l, auto &r) { return l.first < r.first; });
+
+            for (std::size_t num_threads : { 1, 3 }) {
+                auto sorted = data;
+                radix_sort(sorted.begin(), sorted.end(), key_of, num_threads);
+                CHECK(sorted == expected);
+            }
+        }
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_node_size()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using INode = typename tree_type::INode;
+    using Leaf = typename tree_type::Leaf;
+    CHECK(sizeof(INode) <= node_size);
+    CHECK(sizeof(Leaf) <= node_size);
+    CHECK(alignof(INode) >= node_size);
+    CHECK(alignof(Leaf) >= node_size);
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_stats()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+
+    SECTION("empty")
+    {
+        std::vector<std::pair<key_type, value_type>> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        auto stats = tree.stats();
+        REQUIRE(stats.levels.size() == 1);
+        CHECK(stats.num_leaves == 1);
+        CHECK(stats.num_inodes == 0);
+        CHECK(stats.leaves().num_entries == 0);
+        CHECK(stats.leaves().min_fill == 0);
+        CHECK(stats.total_bytes == sizeof(typename tree_type::Leaf));
+        CHECK(stats.bytes_per_key == 0);
+    }
+
+    for (std::size_t n : { 1UL, 1000UL, 100000UL }) {
+        DYNAMIC_SECTION("N = " << n)
+        {
+            std::vector<std::pair<key_type, value_type>> data;
+            for (std::size_t i = 0; i != n; ++i)
+                data.emplace_back(key_type(i), value_type(i));
+            auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+            auto stats = tree.stats();
+
+            REQUIRE(stats.levels.size() == tree.height() + 1);
+            const std::size_t num_leaves = (n + tree_type::NUM_KEYS_PER_LEAF - 1) / tree_type::NUM_KEYS_PER_LEAF;
+            CHECK(stats.num_leaves == num_leaves);
+            CHECK(stats.leaves().num_nodes == num_leaves);
+            CHECK(stats.leaves().num_entries == n);
+            CHECK(stats.levels.front().num_nodes == 1);
+            for (std::size_t l = 0; l + 1 < stats.levels.size(); ++l) {
+                /* Every node of a level is a child of a node of the level above. */
+                CHECK(stats.levels[l].num_entries == stats.levels[l + 1].num_nodes);
+                CHECK(stats.levels[l].min_fill > 0);
+            }
+            for (auto &level : stats.levels) {
+                CHECK(level.min_fill <= level.avg_fill);
+                CHECK(level.avg_fill <= 1);
+            }
+            /* Bulkloading fills all leaves but the last. */
+            CHECK(stats.leaves().avg_fill >= 1. - 1. / num_leaves);
+
+            using Leaf = typename tree_type::Leaf;
+            using INode = typename tree_type::INode;
+            CHECK(stats.total_bytes == stats.num_leaves * sizeof(Leaf) + stats.num_inodes * sizeof(INode));
+            CHECK(stats.padding_bytes == stats.num_leaves * tree_type::LEAF_PADDING_IN_BYTES +
+                                         stats.num_inodes * tree_type::INODE_PADDING_IN_BYTES);
+            CHECK(stats.padding_bytes + stats.unused_bytes < stats.total_bytes);
+            CHECK(stats.bytes_per_key == Approx(double(stats.total_bytes) / n));
+        }
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_bulkload_fill_factor()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    constexpr std::size_t N = 100000;
+
+    std::vector<std::pair<key_type, value_type>> data;
+    for (std::size_t i = 0; i != N; ++i)
+        data.emplace_back(key_type(i), value_type(i));
+
+    for (double fill : { 1., .9, .7, .5, .01 }) {
+        DYNAMIC_SECTION("fill " << fill)
+        {
+            auto tree = tree_type::Bulkload(data.cbegin(), data.cend(), fill, fill);
+            REQUIRE(tree.size() == N);
+            std::size_t i = 0;
+            for (auto p : tree) {
+                CHECK(p.first() == key_type(i));
+                ++i;
+            }
+            CHECK(i == N);
+
+            const std::size_t keys_per_leaf =
+                std::clamp<std::size_t>(fill * tree_type::NUM_KEYS_PER_LEAF, 1, tree_type::NUM_KEYS_PER_LEAF);
+            auto stats = tree.stats();
+            CHECK(stats.num_leaves == (N + keys_per_leaf - 1) / keys_per_leaf);
+            CHECK(stats.levels.size() == tree.height() + 1);
+            for (std::size_t l = 0; l + 1 < stats.levels.size(); ++l)
+                CHECK(stats.levels[l].num_entries == stats.levels[l + 1].num_nodes);
+            const std::size_t children_per_inode = std::clamp<std::size_t>(
+                fill * (tree_type::NUM_KEYS_PER_INODE + 1), 2, tree_type::NUM_KEYS_PER_INODE + 1);
+            if (stats.levels.size() > 2) {
+                /* All inner nodes but the last of the level below the root are filled to the fill factor. */
+                auto &level = stats.levels[1];
+                CHECK(level.num_nodes == (level.num_entries + children_per_inode - 1) / children_per_inode);
+            }
+
+            for (std::size_t k = 0; k < N; k += 997) {
+                auto it = tree.find(key_type(k));
+                REQUIRE(it != tree.end());
+                CHECK((*it).second() == value_type(k));
+            }
+        }
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_histogram()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+
+    SECTION("empty")
+    {
+        std::vector<std::pair<key_type, value_type>> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        auto histogram = tree.histogram(16);
+        CHECK(histogram.buckets.empty());
+        CHECK(histogram.num_keys == 0);
+        CHECK(histogram.estimate_range(0, 100) == 0);
+    }
+
+    /* Every key occurs `multiplicity` times. */
+    for (std::size_t n : { 1UL, 1000UL, 100000UL }) {
+        for (std::size_t multiplicity : { 1UL, 7UL }) {
+            DYNAMIC_SECTION("N = " << n << ", multiplicity = " << multiplicity)
+            {
+                std::vector<std::pair<key_type, value_type>> data;
+                for (std::size_t i = 0; i != n; ++i)
+                    data.emplace_back(key_type(i / multiplicity), value_type(i));
+                auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+                const std::size_t num_distinct = (n + multiplicity - 1) / multiplicity;
+
+                for (std::size_t num_buckets : { 1UL, 10UL, 64UL }) {
+                    /* Sampling all leaves counts the distinct keys exactly. */
+                    auto exact = tree.histogram(num_buckets, std::numeric_limits<std::size_t>::max());
+                    REQUIRE(exact.buckets.size() == std::min(num_buckets, n));
+                    CHECK(exact.num_keys == n);
+                    std::size_t sum = 0;
+                    for (std::size_t b = 0; b != exact.buckets.size(); ++b) {
+                        auto &bucket = exact.buckets[b];
+                        sum += bucket.count;
+                        CHECK(bucket.count >= n / exact.buckets.size());
+                        CHECK(bucket.count <= n / exact.buckets.size() + 1);
+                        CHECK(bucket.lo <= bucket.hi);
+                        if (b) CHECK(exact.buckets[b - 1].hi <= bucket.lo);
+                    }
+                    CHECK(sum == n);
+                    CHECK(exact.buckets.front().lo == data.front().first);
+                    CHECK(exact.buckets.back().hi == data.back().first);
+                    CHECK(exact.num_distinct == num_distinct);
+
+                    /* Sampling estimates unique keys exactly, since every sampled pair of keys differs. */
+                    if (multiplicity == 1)
+                        CHECK(tree.histogram(num_buckets, 1).num_distinct == num_distinct);
+                    /* Otherwise, the estimate is as good as the sampled pairs are many. */
+                    auto sampled = tree.histogram(num_buckets);
+                    CHECK(sampled.num_distinct >= num_distinct / 2.);
+                    CHECK(sampled.num_distinct <= num_distinct * 2.);
+                    if (tree_type::NUM_KEYS_PER_LEAF >= 16)
+                        CHECK(sampled.num_distinct == Approx(num_distinct).epsilon(.1));
+
+                    /* Estimate ranges. */
+                    const key_type max = data.back().first;
+                    for (auto [lo, hi] : { std::pair<key_type, key_type>{ 0, max / 2 },
+                                           std::pair<key_type, key_type>{ max / 3, max } }) {
+                        const std::size_t actual = std::count_if(data.begin(), data.end(), [&](auto &p) {
+                            return lo <= p.first and p.first < hi;
+                        });
+                        CHECK(exact.estimate_range(lo, hi) ==
+                              Approx(actual).epsilon(.01).margin(2 * multiplicity));
+                    }
+                    CHECK(exact.selectivity(0, max + 1) == Approx(1));
+                    /* Buckets with few keys skew the frequency of keys cut off at the bucket boundaries. */
+                    CHECK(exact.estimate_equal(0) >= 1);
+                    if (num_buckets == 1)
+                        CHECK(exact.estimate_equal(0) == Approx(std::min(n, multiplicity)).epsilon(.01));
+                }
+            }
+        }
+    }
+
+    SECTION("fill factors and insert")
+    {
+        /* The histogram depends on the keys only, not on the fill of the nodes or whether pairs were inserted. */
+        std::vector<std::pair<key_type, value_type>> data;
+        for (std::size_t i = 0; i != 20000; ++i)
+            data.emplace_back(key_type(i / 3), value_type(i));
+        const auto middle = data.cbegin() + data.size() / 2;
+        auto full = tree_type::Bulkload(data.cbegin(), data.cend());
+        auto sparse = tree_type::Bulkload(data.cbegin(), data.cend(), .5, .5);
+        auto inserted = tree_type::Bulkload(data.cbegin(), middle, .5, .5);
+        for (auto it = middle; it != data.cend(); ++it)
+            inserted.insert(it->first, it->second);
+
+        for (const tree_type *tree : { &sparse, &inserted }) {
+            for (std::size_t num_buckets : { 1UL, 10UL, 64UL }) {
+                auto expected = full.histogram(num_buckets, std::numeric_limits<std::size_t>::max());
+                auto actual = tree->histogram(num_buckets, std::numeric_limits<std::size_t>::max());
+                REQUIRE(actual.buckets.size() == expected.buckets.size());
+                CHECK(actual.num_distinct == expected.num_distinct);
+                for (std::size_t b = 0; b != actual.buckets.size(); ++b) {
+                    CHECK(actual.buckets[b].lo == expected.buckets[b].lo);
+                    CHECK(actual.buckets[b].hi == expected.buckets[b].hi);
+                    CHECK(actual.buckets[b].count == expected.buckets[b].count);
+                    CHECK(actual.buckets[b].num_distinct == expected.buckets[b].num_distinct);
+                }
+                CHECK(tree->histogram(num_buckets).num_distinct == Approx(expected.num_distinct).epsilon(.5));
+            }
+        }
+    }
+}
+
+}
+
+
+TEST_CASE("radix_sort", "[milestone2]")
+{
+#define TEST(KEY) \
+    DYNAMIC_SECTION(#KEY) \
+    { __test_radix_sort<KEY>(); }
+
+    TEST(int16_t);
+    TEST(uint16_t);
+    TEST(int32_t);
+    TEST(uint32_t);
+    TEST(int64_t);
+    TEST(uint64_t);
+
+#undef TEST
+
+    SECTION("comparison sort fallback")
+    {
+        std::vector<std::pair<double, int>> data = { { 2.5, 0 }, { -1., 1 }, { 2.5, 2 }, { 0., 3 } };
+        sort_by_key(data.begin(), data.end(), [](auto &p) { return p.first; });
+        CHECK(data == std::vector<std::pair<double, int>>{ { -1., 1 }, { 0., 3 }, { 2.5, 0 }, { 2.5, 2 } });
+    }
+}
+
+
+TEST_CASE("BTree/node size", "[milestone2]")
+{
 #define TEST(KEY, VALUE, NODE_SIZE) \
-    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) { test.template operator()<KEY, VALUE, NODE_SIZE>(); }
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_node_size<KEY, VALUE, NODE_SIZE>(); }
+
     TEST(int32_t, int32_t, 4096);
     TEST(int64_t, int32_t, 4096);
     TEST(int32_t, int64_t, 4096);
@@ -711,6 +1256,11 @@ TEST_CASE("BTree/node size", "[milestone2]")
     TEST(int64_t, int32_t, 512);
     TEST(int32_t, int64_t, 512);
     TEST(int64_t, int64_t, 512);
+
+    using char32 = std::array<char, 32>; // e.g. `CHAR(32)`
+    TEST(char32, int32_t, 512);
+    TEST(char32, int32_t, 4096);
+
 #undef TEST
 }
 
@@ -730,6 +1280,92 @@ TEST_CASE("BTree/Bulkload", "[milestone2]")
 #undef TEST
 }
 
+TEST_CASE("BTree/BulkloadUnsorted", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_bulkload_unsorted<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+    TEST(uint64_t, int32_t, 512);
+
+    TEST(int32_t, int32_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/Bulkload fill factor", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_bulkload_fill_factor<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 512);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/insert", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_insert<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 512);
+
+    TEST(int32_t, int32_t, 64);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/stats", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_stats<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+    TEST(int64_t, int32_t, 512);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/histogram", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_histogram<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 512);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+
+    SECTION("JSON")
+    {
+        std::vector<std::pair<int32_t, int32_t>> data;
+        for (int32_t i = 0; i != 1000; ++i)
+            data.emplace_back(i / 2, i);
+        auto tree = BTree<int32_t, int32_t, 512>::Bulkload(data.cbegin(), data.cend());
+        std::ostringstream oss;
+        write_cardinalities_json(oss, "db", "packages", "size", tree.histogram(4, std::numeric_limits<std::size_t>::max()));
+        const std::string json = oss.str();
+        CHECK(json.find("\"db\": [") != std::string::npos);
+        CHECK(json.find("\"relations\": [\"packages\"], \"size\": 1000") != std::string::npos);
+        CHECK(json.find("\"distinct\": 500,") != std::string::npos);
+        CHECK(json.find("{ \"lo\": 0, \"hi\": 124, \"count\": 250, \"distinct\": 125 }") != std::string::npos);
+        CHECK(json.find("{ \"lo\": 375, \"hi\": 499, \"count\": 250, \"distinct\": 125 }") != std::string::npos);
+    }
+}
+
 TEST_CASE("BTree/find", "[milestone2]")
 {
 #define TEST(KEY, VALUE, NODE_SIZE) \
@@ -774,3 +1410,56 @@ TEST_CASE("BTree/equal_range", "[milestone2]")
 
 #undef TEST
 }
+
+TEST_CASE("BTree/parallel_scan", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_parallel_scan<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+
+    TEST(int32_t, int32_t, 64);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/node search", "[milestone2]")
+{
+#define TEST(SEARCH, KEY) \
+    DYNAMIC_SECTION((#SEARCH ", " #KEY)) \
+    { __test_node_search<SEARCH, KEY>(); }
+
+    TEST(linear_search, int32_t);
+    TEST(linear_search, int64_t);
+    TEST(binary_search, int32_t);
+    TEST(binary_search, int64_t);
+    TEST(simd_search, int32_t);
+    TEST(simd_search, int64_t);
+    TEST(interpolation_search, int32_t);
+    TEST(interpolation_search, int64_t);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/search policies", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE, SEARCH) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B, " #SEARCH)) \
+    { \
+        __test_find<KEY, VALUE, NODE_SIZE, SEARCH>(); \
+        __test_find_range<KEY, VALUE, NODE_SIZE, SEARCH>(); \
+        __test_equal_range<KEY, VALUE, NODE_SIZE, SEARCH>(); \
+    }
+
+    TEST(int32_t, int32_t, 4096, binary_search);
+    TEST(int64_t, int64_t,   64, binary_search);
+    TEST(int32_t, int32_t, 4096, simd_search);
+    TEST(int64_t, int64_t,   64, simd_search);
+    TEST(int32_t, int32_t, 4096, interpolation_search);
+    TEST(int64_t, int64_t,   64, interpolation_search);
+
+#undef TEST
+}
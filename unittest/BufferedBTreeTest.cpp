@@ -0,0 +1,104 @@
+#include "catch2/catch.hpp"
+
+#include "BufferedBTree.hpp"
+#include <map>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+template<typename Tree, typename Model>
+void check_equal(const Tree &tree, const Model &model)
+{
+    std::vector<std::pair<typename Tree::key_type, typename Tree::mapped_type>> contents;
+    tree.for_each([&contents](auto key, auto value) { contents.emplace_back(key, value); });
+    std::vector<std::pair<typename Tree::key_type, typename Tree::mapped_type>> expected(model.begin(), model.end());
+    CHECK(contents == expected);
+}
+
+template<typename key_type, typename value_type, std::size_t node_size, std::size_t buffer_size>
+void __test_buffered_btree()
+{
+    using tree_type = BufferedBTree<key_type, value_type, node_size, buffer_size>;
+
+    SECTION("empty")
+    {
+        tree_type tree;
+        CHECK(tree.height() == 0);
+        CHECK_FALSE(tree.find(42));
+        tree.erase(42);
+        CHECK_FALSE(tree.find(42));
+        tree.flush_all();
+        check_equal(tree, std::map<key_type, value_type>());
+    }
+
+    SECTION("insert, overwrite, and erase")
+    {
+        tree_type tree;
+        std::map<key_type, value_type> model;
+        std::mt19937 g(42);
+        std::uniform_int_distribution<key_type> dist_key(0, 5'000);
+
+        for (unsigned i = 0; i != 20'000; ++i) {
+            const key_type key = dist_key(g);
+            if (i % 3 == 2) {
+                tree.erase(key);
+                model.erase(key);
+            } else {
+                tree.insert(key, i);
+                model[key] = i;
+            }
+        }
+        CHECK(tree.height() > 0);
+
+        /* Lookups must see buffered messages. */
+        for (key_type key = -1; key <= 5'001; ++key) {
+            auto it = model.find(key);
+            auto value = tree.find(key);
+            REQUIRE(value.has_value() == (it != model.end()));
+            if (value) CHECK(*value == it->second);
+        }
+
+        tree.flush_all();
+        check_equal(tree, model);
+        for (key_type key = 0; key <= 5'000; key += 7)
+            CHECK(tree.find(key).has_value() == model.contains(key));
+    }
+
+    SECTION("sequential inserts")
+    {
+        tree_type tree;
+        std::map<key_type, value_type> model;
+        for (key_type key = 0; key != 10'000; ++key) {
+            tree.insert(key, 2 * key);
+            model.emplace(key, 2 * key);
+        }
+        for (key_type key = 0; key != 10'000; key += 2) {
+            tree.erase(key);
+            model.erase(key);
+        }
+        tree.flush_all();
+        check_equal(tree, model);
+    }
+}
+
+}
+
+
+TEST_CASE("BufferedBTree", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE, BUFFER_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B, " #BUFFER_SIZE "B buffer")) \
+    { __test_buffered_btree<KEY, VALUE, NODE_SIZE, BUFFER_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096, 2048);
+    TEST(int64_t, int64_t, 4096, 2048);
+    TEST(int32_t, int32_t, 4096, 0);
+
+    TEST(int32_t, int32_t, 256, 128);
+    TEST(int64_t, int64_t, 256, 128);
+    TEST(int64_t, int64_t, 256, 0);
+
+#undef TEST
+}
@@ -0,0 +1,100 @@
+#include "catch2/catch.hpp"
+
+#include "HashIndex.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+template<typename key_type, typename value_type>
+void __test_hash_index()
+{
+    using index_type = HashIndex<key_type, value_type>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    SECTION("empty")
+    {
+        std::vector<pair_type> data;
+        auto index = index_type::Bulkload(data.cbegin(), data.cend());
+        CHECK(index.size() == 0);
+        CHECK(index.begin() == index.end());
+        CHECK(index.find(42) == index.end());
+        CHECK(index.equal_range(42).empty());
+    }
+
+    SECTION("random with duplicates")
+    {
+        std::mt19937 g(42);
+        std::uniform_int_distribution<key_type> dist_key(-10'000, 10'000);
+        std::uniform_int_distribution<int> dist_repetition(1, 5);
+
+        std::vector<pair_type> data;
+        for (value_type i = 0; i != 5'000; ++i) {
+            const key_type key = dist_key(g);
+            for (int n = dist_repetition(g); n; --n)
+                data.emplace_back(key, i);
+        }
+        std::stable_sort(data.begin(), data.end(), [](auto &l, auto &r) { return l.first < r.first; });
+        auto index = index_type::Bulkload(data.cbegin(), data.cend());
+        REQUIRE(index.size() == data.size());
+        CHECK(index.capacity() % index_type::GROUP_SIZE == 0);
+
+        auto less = [](const pair_type &p, const key_type &k) { return p.first < k; };
+        for (key_type key = -10'100; key <= 10'100; ++key) {
+            const auto expected = std::lower_bound(data.begin(), data.end(), key, less);
+            const bool hit = expected != data.end() and expected->first == key;
+
+            auto it = index.find(key);
+            if (hit) {
+                REQUIRE(it != index.end());
+                CHECK((*it).first() == key);
+                CHECK((*it).second() == expected->second);
+            } else {
+                CHECK(it == index.end());
+            }
+
+            std::size_t count = 0;
+            for (auto e : index.equal_range(key)) {
+                CHECK(e.first() == key);
+                CHECK(e.second() == (expected + count)->second);
+                ++count;
+            }
+            CHECK(count == std::size_t(std::upper_bound(data.begin(), data.end(), key,
+                                                        [](const key_type &k, const pair_type &p) {
+                                                            return k < p.first;
+                                                        }) - expected));
+        }
+    }
+
+    SECTION("colliding fingerprints")
+    {
+        /* Keys that are multiples of a large power of 2 stress the mixing of the hash. */
+        std::vector<pair_type> data;
+        for (value_type i = 0; i != 1'000; ++i)
+            data.emplace_back(key_type(i) << (8 * sizeof(key_type) - 12), i);
+        auto index = index_type::Bulkload(data.cbegin(), data.cend());
+        for (auto &[key, value] : data) {
+            auto it = index.find(key);
+            REQUIRE(it != index.end());
+            CHECK((*it).second() == value);
+        }
+    }
+}
+
+}
+
+
+TEST_CASE("HashIndex", "[milestone2]")
+{
+#define TEST(KEY, VALUE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE)) \
+    { __test_hash_index<KEY, VALUE>(); }
+
+    TEST(int32_t, int32_t);
+    TEST(int64_t, int64_t);
+
+#undef TEST
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/* Shared tests of the indexes with the lookup interface of `BTree`, e.g. `ART` and `VEBTree`. */
+
+/** Returns the \p i-th key of type \p key_type.  Character sequences are strings with a common prefix longer than the
+ * `MAX_PREFIX_LENGTH` of `ART` and with different lengths, padded with NUL characters. */
+template<typename key_type>
+key_type make_key(int64_t i)
+{
+    if constexpr (std::is_integral_v<key_type>) {
+        return key_type(i);
+    } else {
+        key_type key{};
+        const std::string str = "packages/" + std::to_string(i);
+        std::copy_n(str.begin(), std::min(str.size(), key.size()), key.begin());
+        return key;
+    }
+}
+
+/** Tests the lookup interface of the index \p Index, i.e. `Bulkload()`, iteration, `find()`, `equal_range()`, and
+ * `find_range()`, against a sorted vector of pairs.  The structure of the index is checked by \p check_single, called
+ * with an index of one pair, and \p check_many, called with an index of thousands of pairs. */
+template<typename Index, typename CheckSingle, typename CheckMany>
+void __test_lookup_index(CheckSingle check_single, CheckMany check_many)
+{
+    using tree_type = Index;
+    using key_type = typename tree_type::key_type;
+    using value_type = typename tree_type::mapped_type;
+    using pair_type = std::pair<key_type, value_type>;
+
+    SECTION("empty")
+    {
+        std::vector<pair_type> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        CHECK(tree.size() == 0);
+        CHECK(tree.begin() == tree.end());
+        CHECK(tree.find(make_key<key_type>(42)) == tree.end());
+        CHECK(tree.find_range(make_key<key_type>(0), make_key<key_type>(100)).empty());
+    }
+
+    SECTION("N = 1")
+    {
+        std::vector<pair_type> data{ { make_key<key_type>(42), 1 } };
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        CHECK(tree.size() == 1);
+        check_single(tree);
+        auto it = tree.find(make_key<key_type>(42));
+        REQUIRE(it != tree.end());
+        CHECK((*it).second() == 1);
+        CHECK(tree.find(make_key<key_type>(41)) == tree.end());
+    }
+
+    SECTION("random with duplicates")
+    {
+        std::mt19937 g(42);
+        std::uniform_int_distribution<int64_t> dist_key(-5'000, 5'000);
+        std::uniform_int_distribution<int> dist_repetition(1, 3);
+
+        std::vector<pair_type> data;
+        for (value_type i = 0; i != 3'000; ++i) {
+            const key_type key = make_key<key_type>(dist_key(g));
+            for (int n = dist_repetition(g); n; --n)
+                data.emplace_back(key, i);
+        }
+        std::stable_sort(data.begin(), data.end(), [](auto &l, auto &r) { return l.first < r.first; });
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        REQUIRE(tree.size() == data.size());
+        check_many(tree);
+
+        /* Iteration yields all pairs in order. */
+        std::size_t i = 0;
+        for (auto it = tree.cbegin(); it != tree.cend(); ++it, ++i) {
+            CHECK((*it).first() == data[i].first);
+            CHECK((*it).second() == data[i].second);
+        }
+        CHECK(i == data.size());
+
+        auto less = [](const pair_type &p, const key_type &k) { return p.first < k; };
+        for (int64_t k = -5'100; k <= 5'100; k += 3) {
+            const key_type key = make_key<key_type>(k);
+            const auto expected = std::lower_bound(data.begin(), data.end(), key, less);
+            const bool hit = expected != data.end() and expected->first == key;
+
+            /* find */
+            auto it = tree.find(key);
+            if (hit) {
+                REQUIRE(it != tree.end());
+                CHECK((*it).first() == key);
+                CHECK((*it).second() == expected->second);
+            } else {
+                CHECK(it == tree.end());
+            }
+
+            /* equal_range */
+            auto er = tree.equal_range(key);
+            std::size_t count = 0;
+            for (auto e : er) {
+                CHECK(e.first() == key);
+                ++count;
+            }
+            CHECK(count == std::size_t(std::count_if(data.begin(), data.end(),
+                                                     [&key](auto &p) { return p.first == key; })));
+
+            /* find_range */
+            const key_type hi = make_key<key_type>(k + 250);
+            if (key < hi) {
+                auto range = tree.find_range(key, hi);
+                auto expected_end = std::lower_bound(data.begin(), data.end(), hi, less);
+                std::size_t n = 0;
+                for (auto e : range) {
+                    CHECK_FALSE(e.first() < key);
+                    CHECK(e.first() < hi);
+                    ++n;
+                }
+                CHECK(n == std::size_t(expected_end - expected));
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "catch2/catch.hpp"
+
+#include "BTree.hpp"
+#include "LookupCache.hpp"
+#include <random>
+#include <vector>
+
+
+namespace {
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_lookup_cache()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using cache_type = LookupCache<tree_type, 64>;
+
+    std::vector<std::pair<key_type, value_type>> data;
+    for (key_type key = 0; key != 10'000; ++key)
+        data.emplace_back(2 * key, key);
+    const auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+    cache_type cache(tree);
+
+    SECTION("hits and misses")
+    {
+        CHECK(cache.find(42) == tree.find(42));
+        CHECK(cache.num_hits() == 0);
+        CHECK(cache.num_misses() == 1);
+
+        CHECK(cache.find(42) == tree.find(42));
+        CHECK(cache.find(43) == tree.cend());
+        CHECK(cache.find(43) == tree.cend());
+        CHECK(cache.num_hits() == 2);
+        CHECK(cache.num_misses() == 2);
+
+        cache.clear();
+        CHECK(cache.num_hits() == 0);
+        CHECK(cache.find(42) == tree.find(42));
+        CHECK(cache.num_misses() == 1);
+    }
+
+    SECTION("skewed lookups")
+    {
+        std::mt19937 g(42);
+        std::geometric_distribution<key_type> dist_key(.05); // a few hot keys
+        for (unsigned i = 0; i != 10'000; ++i) {
+            const key_type key = dist_key(g);
+            auto it = cache.find(key);
+            REQUIRE(it == tree.find(key));
+            if (it != tree.cend())
+                CHECK((*it).second() == key / 2);
+        }
+        CHECK(cache.num_hits() + cache.num_misses() == 10'000);
+        CHECK(cache.num_hits() > cache.num_misses());
+    }
+}
+
+}
+
+
+TEST_CASE("LookupCache", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_lookup_cache<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
@@ -0,0 +1,62 @@
+#include "catch2/catch.hpp"
+
+#include "BTree.hpp"
+#include "ReplicatedIndex.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("numa/parse_list", "[milestone2]")
+{
+    CHECK(numa::parse_list("0") == std::vector<unsigned>{ 0 });
+    CHECK(numa::parse_list("0-3,8,10-11\n") == std::vector<unsigned>{ 0, 1, 2, 3, 8, 10, 11 });
+    CHECK(numa::parse_list("").empty());
+}
+
+TEST_CASE("numa/topology", "[milestone2]")
+{
+    const auto &topo = numa::topology::Get();
+    REQUIRE(topo.num_nodes() >= 1);
+    REQUIRE(topo.cpus.size() == topo.num_nodes());
+    for (auto &cpus : topo.cpus)
+        CHECK_FALSE(cpus.empty());
+    CHECK(topo.current_node() < topo.num_nodes());
+}
+
+TEST_CASE("ReplicatedIndex", "[milestone2]")
+{
+    using tree_type = BTree<int32_t, int32_t, 512>;
+    std::vector<std::pair<int32_t, int32_t>> data;
+    for (int32_t key = 0; key != 10'000; ++key)
+        data.emplace_back(2 * key, key);
+
+    auto replicated = ReplicatedIndex<tree_type>::Bulkload(data.cbegin(), data.cend());
+    REQUIRE(replicated.num_replicas() == numa::topology::Get().num_nodes());
+
+    for (std::size_t node = 0; node != replicated.num_replicas(); ++node) {
+        const auto &tree = replicated.replica(node);
+        CHECK(tree.size() == data.size());
+        auto it = tree.find(42);
+        REQUIRE(it != tree.cend());
+        CHECK((*it).second() == 21);
+        CHECK(tree.find(43) == tree.cend());
+    }
+
+    /* Threads pinned to every node find all keys in their local replica. */
+    std::atomic_bool ok = true;
+    std::vector<std::thread> threads;
+    for (std::size_t node = 0; node != replicated.num_replicas(); ++node) {
+        threads.emplace_back([&, node]() {
+            numa::pin_thread_to_node(numa::topology::Get(), node);
+            const auto &tree = replicated.local();
+            for (auto &[key, value] : data) {
+                auto it = tree.find(key);
+                if (it == tree.cend() or (*it).second() != value) ok = false;
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    CHECK(ok);
+}
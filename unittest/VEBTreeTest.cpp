@@ -0,0 +1,68 @@
+#include "catch2/catch.hpp"
+
+#include "IndexTest.hpp"
+#include "VEBTree.hpp"
+#include <algorithm>
+#include <bit>
+#include <array>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+using char16 = std::array<char, 16>;
+
+template<typename key_type, typename value_type>
+void __test_veb_tree()
+{
+    using tree_type = VEBTree<key_type, value_type>;
+    __test_lookup_index<tree_type>([](const tree_type &tree) { CHECK(tree.height() == 1); },
+                                   [](const tree_type &tree) { CHECK(tree.height() > 1); });
+}
+
+}
+
+
+TEST_CASE("VEBTree/tree sizes", "[milestone2]")
+{
+    /* Check all keys and the gaps between them, for complete trees and for trees that need padding. */
+    using tree_type = VEBTree<int32_t, int32_t>;
+    for (int32_t n = 1; n != 130; ++n) {
+        std::vector<std::pair<int32_t, int32_t>> data;
+        for (int32_t i = 0; i != n; ++i)
+            data.emplace_back(2 * i, i);
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        REQUIRE(tree.height() == std::size_t(std::bit_width(unsigned(n))));
+
+        for (int32_t key = -1; key <= 2 * n; ++key) {
+            auto it = tree.find(key);
+            if (key >= 0 and key % 2 == 0 and key < 2 * n) {
+                REQUIRE(it != tree.end());
+                CHECK((*it).second() == key / 2);
+            } else {
+                CHECK(it == tree.end());
+            }
+
+            std::size_t count = 0;
+            for (auto e : tree.find_range(key, 2 * n)) {
+                CHECK_FALSE(e.first() < key);
+                ++count;
+            }
+            CHECK(count == std::size_t(key <= 0 ? n : n - (key + 1) / 2));
+        }
+    }
+}
+
+TEST_CASE("VEBTree", "[milestone2]")
+{
+#define TEST(KEY, VALUE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE)) \
+    { __test_veb_tree<KEY, VALUE>(); }
+
+    TEST(int32_t, int32_t);
+    TEST(int64_t, int64_t);
+    TEST(char16, int32_t);
+
+#undef TEST
+}
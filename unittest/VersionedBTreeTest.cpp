@@ -0,0 +1,162 @@
+#include "catch2/catch.hpp"
+
+#include "VersionedBTree.hpp"
+#include <atomic>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+template<typename Tree, typename Model>
+void check_equal(const typename Tree::snapshot &snapshot, const Model &model)
+{
+    REQUIRE(snapshot.size() == model.size());
+
+    std::vector<std::pair<typename Tree::key_type, typename Tree::mapped_type>> contents;
+    snapshot.scan(std::numeric_limits<typename Tree::key_type>::lowest(),
+                  std::numeric_limits<typename Tree::key_type>::max(),
+                  [&contents](auto key, auto value) { contents.emplace_back(key, value); });
+    std::vector<std::pair<typename Tree::key_type, typename Tree::mapped_type>> expected(model.begin(), model.end());
+    CHECK(contents == expected);
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_versioned_btree()
+{
+    using tree_type = VersionedBTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    SECTION("empty")
+    {
+        tree_type tree;
+        auto snapshot = tree.get_snapshot();
+        CHECK(snapshot.size() == 0);
+        CHECK(snapshot.height() == 0);
+        CHECK(snapshot.find(42) == nullptr);
+        CHECK_FALSE(tree.erase(42));
+    }
+
+    SECTION("bulkload")
+    {
+        constexpr key_type N = 10'000;
+        std::vector<pair_type> data;
+        for (key_type key = 0; key != N; ++key)
+            data.emplace_back(key, 2 * key + 13);
+
+        tree_type tree(data.cbegin(), data.cend());
+        auto snapshot = tree.get_snapshot();
+        CHECK(snapshot.size() == N);
+
+        for (key_type key = 0; key != N; ++key) {
+            auto value = snapshot.find(key);
+            REQUIRE(value);
+            CHECK(*value == 2 * key + 13);
+        }
+        CHECK(snapshot.find(-1) == nullptr);
+        CHECK(snapshot.find(N) == nullptr);
+
+        std::multimap<key_type, value_type> model(data.begin(), data.end());
+        check_equal<tree_type>(snapshot, model);
+    }
+
+    SECTION("insert and erase")
+    {
+        tree_type tree;
+        std::multimap<key_type, value_type> model;
+        std::mt19937 g(42);
+        std::uniform_int_distribution<key_type> dist_key(0, 500);
+
+        for (unsigned i = 0; i != 5'000; ++i) {
+            const key_type key = dist_key(g);
+            tree.insert(key, i);
+            model.emplace(key, i); // inserts after all elements with the same key
+        }
+        check_equal<tree_type>(tree.get_snapshot(), model);
+        CHECK(tree.height() > 0);
+
+        for (unsigned i = 0; i != 4'000; ++i) {
+            const key_type key = dist_key(g);
+            auto it = model.lower_bound(key);
+            if (it != model.end() and it->first != key) it = model.end();
+            CHECK(tree.erase(key) == (it != model.end()));
+            if (it != model.end()) model.erase(it);
+        }
+        check_equal<tree_type>(tree.get_snapshot(), model);
+
+        for (auto &[key, _] : std::multimap<key_type, value_type>(model))
+            CHECK(tree.erase(key));
+        CHECK(tree.size() == 0);
+        CHECK(tree.height() == 0);
+    }
+
+    SECTION("snapshot isolation")
+    {
+        std::vector<pair_type> data;
+        for (key_type key = 0; key != 1'000; ++key)
+            data.emplace_back(2 * key, key);
+
+        tree_type tree(data.cbegin(), data.cend());
+        std::multimap<key_type, value_type> model(data.begin(), data.end());
+        auto old_snapshot = tree.get_snapshot();
+
+        for (key_type key = 0; key != 1'000; ++key)
+            tree.insert(2 * key + 1, key);
+        for (key_type key = 0; key != 500; ++key)
+            tree.erase(2 * key);
+
+        check_equal<tree_type>(old_snapshot, model);
+        CHECK(tree.size() == 1'500);
+
+        tree.assign(data.cbegin(), data.cend());
+        check_equal<tree_type>(tree.get_snapshot(), model);
+    }
+
+    SECTION("concurrent readers")
+    {
+        std::vector<pair_type> data;
+        for (key_type key = 0; key != 1'000; ++key)
+            data.emplace_back(key, key);
+
+        tree_type tree(data.cbegin(), data.cend());
+        std::atomic_bool done = false;
+        std::thread writer([&]() {
+            for (key_type key = 1'000; key != 3'000; ++key)
+                tree.insert(key, key);
+            done = true;
+        });
+
+        bool consistent = true;
+        do {
+            auto snapshot = tree.get_snapshot();
+            std::size_t count = 0;
+            snapshot.scan(0, 3'000, [&](auto key, auto value) { consistent &= (key == value); ++count; });
+            consistent &= (count == snapshot.size());
+        } while (not done);
+        writer.join();
+
+        CHECK(consistent);
+        CHECK(tree.size() == 3'000);
+    }
+}
+
+}
+
+
+TEST_CASE("VersionedBTree", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_versioned_btree<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+
+    TEST(int32_t, int32_t, 128);
+    TEST(int64_t, int64_t, 128);
+
+#undef TEST
+}
@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include "bitpacking.hpp"
+#include <limits>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+/** Appends `rows` to `table`, flushes it, and checks that a scan of all columns returns `rows`. */
+void check_roundtrip(bitpacked_pax_table &table, const std::vector<std::vector<int32_t>> &rows)
+{
+    for (auto &row : rows)
+        table.append(row.data());
+    table.flush();
+    REQUIRE(table.size() == rows.size());
+
+    std::vector<std::size_t> columns(table.num_columns());
+    for (std::size_t c = 0; c != columns.size(); ++c)
+        columns[c] = c;
+    std::vector<std::vector<int32_t>> scanned;
+    table.scan(columns, [&](const int32_t *const *values, std::size_t n) {
+        for (std::size_t i = 0; i != n; ++i) {
+            auto &row = scanned.emplace_back();
+            for (std::size_t c = 0; c != columns.size(); ++c)
+                row.push_back(values[c][i]);
+        }
+    });
+    CHECK(scanned == rows);
+}
+
+}
+
+TEST_CASE("bitpacked_pax_table", "[milestone1]")
+{
+    std::mt19937 g(42);
+
+    SECTION("pack and unpack")
+    {
+        for (unsigned bits = 0; bits <= 32; ++bits) {
+            DYNAMIC_SECTION(bits << " bits")
+            {
+                const int32_t base = -1000;
+                std::uniform_int_distribution<uint32_t> dist(0, bits ? uint32_t(-1) >> (32 - bits) : 0);
+                std::vector<int32_t> values(37);
+                for (auto &v : values)
+                    v = int32_t(uint32_t(base) + dist(g));
+                std::vector<uint64_t> words((values.size() * bits + 63) / 64 + 1, 0);
+                detail::pack(values.data(), values.size(), bits, base, words.data());
+                std::vector<int32_t> unpacked(values.size());
+                detail::unpack(words.data(), values.size(), bits, base, unpacked.data());
+                CHECK(unpacked == values);
+            }
+        }
+    }
+
+    SECTION("narrow values")
+    {
+        /* Consecutive keys and doubled values, as in the scan benchmarks. */
+        std::vector<std::vector<int32_t>> rows;
+        for (int32_t i = 0; i != 10000; ++i)
+            rows.push_back({ i, i << 1, i << 1, i << 1 });
+        bitpacked_pax_table compressed(4);
+        check_roundtrip(compressed, rows);
+        bitpacked_pax_table plain(4, 4096, false);
+        check_roundtrip(plain, rows);
+
+        /* A plain block holds 256 rows of four 32 bit values, a compressed one more. */
+        CHECK(plain.blocks().front().num_tuples == 256);
+        CHECK(compressed.blocks().front().num_tuples > 2 * 256);
+        CHECK(compressed.blocks().size() < plain.blocks().size() / 2);
+        CHECK(compressed.size_in_bytes() < plain.size_in_bytes() / 2);
+        for (auto &b : compressed.blocks()) {
+            CHECK(b.minipages[0].base >= 0);
+            CHECK(b.minipages[0].bits < 32);
+        }
+    }
+
+    SECTION("wide and negative values")
+    {
+        std::uniform_int_distribution<int32_t> dist(std::numeric_limits<int32_t>::min(),
+                                                    std::numeric_limits<int32_t>::max());
+        std::vector<std::vector<int32_t>> rows;
+        for (std::size_t i = 0; i != 3000; ++i)
+            rows.push_back({ dist(g), -int32_t(i), 7 });
+        bitpacked_pax_table table(3, 1024);
+        check_roundtrip(table, rows);
+        for (auto &b : table.blocks()) {
+            CHECK(b.minipages[2].bits == 0);
+            CHECK(b.minipages[2].base == 7);
+        }
+    }
+
+    SECTION("partial scan")
+    {
+        bitpacked_pax_table table(3);
+        int64_t expected = 0;
+        for (int32_t i = 0; i != 5000; ++i) {
+            const int32_t row[] = { i, 3 * i, -i };
+            table.append(row);
+            expected += row[2];
+        }
+        table.flush();
+        int64_t sum = 0;
+        std::size_t count = 0;
+        table.scan({ 2 }, [&](const int32_t *const *values, std::size_t n) {
+            for (std::size_t i = 0; i != n; ++i)
+                sum += values[0][i];
+            count += n;
+        });
+        CHECK(count == 5000);
+        CHECK(sum == expected);
+    }
+}
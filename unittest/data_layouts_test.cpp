@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include "data_layouts.hpp"
+#include <sstream>
 
 
 using namespace m;
@@ -1155,3 +1156,405 @@ TEST_CASE("PAXLayout", "[milestone1]")
         CHECK(null_bitmap->type()->size() == 5);
     }
 }
+
+TEST_CASE("PAXLayout/block size", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    const std::pair<const char*, std::size_t> block_sizes[] = {
+        { "PAX1k", 1024 }, { "PAX16k", 16 * 1024 }, { "PAX64k", 64 * 1024 }, { "PAX1M", 1024 * 1024 },
+    };
+    for (auto [name, block_size] : block_sizes) {
+        try {
+            C.register_data_layout(name, std::make_unique<MyPAXLayoutFactory>(block_size), name);
+        } catch (std::invalid_argument) { }
+    }
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    /* Fill table with attributes. */
+    table.push_back(C.pool("a"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.store(C.create_store(table));
+
+    for (auto [name, block_size] : block_sizes) {
+        DYNAMIC_SECTION(name)
+        {
+            table.layout(C.data_layout(name));
+            const auto &layout = table.layout();
+
+            /* Check stride of blocks. */
+            CHECK(layout.stride_in_bits() == block_size * 8);
+
+            /* Every tuple takes 32 bits for `a` and 1 bit for the NULL bitmap. */
+            const std::size_t num_tuples = block_size * 8 / 33;
+            CHECK(layout.child().num_tuples() == num_tuples);
+
+            auto inode = cast<const DataLayout::INode>(&layout.child());
+            REQUIRE(inode);
+            REQUIRE(inode->num_children() == 2);
+            CHECK(inode->at(0).offset_in_bits == 0);
+            CHECK(inode->at(0).stride_in_bits == 32);
+            CHECK(inode->at(1).offset_in_bits == num_tuples * 32);
+            CHECK(inode->at(1).stride_in_bits == 1);
+        }
+    }
+
+    SECTION("auto")
+    {
+        MyPAXLayoutFactory factory(MyPAXLayoutFactory::AUTO);
+        const std::size_t l2_size = detect_cache_size(2);
+        if (l2_size)
+            CHECK(factory.block_size_in_bytes() == l2_size);
+        else
+            CHECK(factory.block_size_in_bytes() == 4096);
+
+        try {
+            C.register_data_layout("PAXauto", std::make_unique<MyPAXLayoutFactory>(MyPAXLayoutFactory::AUTO),
+                                   "PAXauto");
+        } catch (std::invalid_argument) { }
+        table.layout(C.data_layout("PAXauto"));
+        CHECK(table.layout().stride_in_bits() == factory.block_size_in_bytes() * 8);
+    }
+}
+
+TEST_CASE("OutOfLineRowLayout", "[milestone1]")
+{
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 4),  // id
+        Type::Get_Char(Type::TY_Vector, 10),    // repo
+        Type::Get_Char(Type::TY_Vector, 32),    // pkg_name
+        Type::Get_Char(Type::TY_Vector, 80),    // description
+        Type::Get_Integer(Type::TY_Vector, 8),  // size
+    };
+
+    SECTION("wide attributes in heap regions")
+    {
+        MyOutOfLineRowLayoutFactory factory;
+        CHECK(factory.threshold_in_bytes() == 32);
+        auto layout = factory.make(types, 1000);
+
+        /* Root must be an indefinite sequence of chunks. */
+        CHECK(not layout.is_finite());
+        CHECK(layout.stride_in_bits() == 1088000); // 1000 rows of 448 bits and 1000 descriptions, aligned to 512 bits
+
+        auto chunk = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(chunk);
+        CHECK(chunk->num_tuples() == 1000);
+        REQUIRE(chunk->num_children() == 2);
+
+        /* The rows hold `size`, `id`, `repo`, `pkg_name` and the NULL bitmap. */
+        auto rows = cast<const DataLayout::INode>(chunk->at(0).ptr.get());
+        REQUIRE(rows);
+        CHECK(chunk->at(0).offset_in_bits == 0);
+        CHECK(chunk->at(0).stride_in_bits == 448);
+        CHECK(rows->num_tuples() == 1);
+        REQUIRE(rows->num_children() == 5);
+        const std::pair<std::size_t, std::size_t> row_leaves[] = { { 4, 0 }, { 0, 64 }, { 1, 96 }, { 2, 176 },
+                                                                   { 5, 432 } };
+        for (std::size_t i = 0; i != 5; ++i) {
+            auto leaf = cast<const DataLayout::Leaf>(rows->at(i).ptr.get());
+            REQUIRE(leaf);
+            CHECK(leaf->index() == row_leaves[i].first);
+            CHECK(rows->at(i).offset_in_bits == row_leaves[i].second);
+            CHECK(rows->at(i).stride_in_bits == 0);
+        }
+        auto null_bitmap = cast<const DataLayout::Leaf>(rows->at(4).ptr.get());
+        CHECK(null_bitmap->type()->is_bitmap());
+        CHECK(null_bitmap->type()->size() == 5);
+
+        /* `description` is stored contiguously after the rows. */
+        auto description = cast<const DataLayout::Leaf>(chunk->at(1).ptr.get());
+        REQUIRE(description);
+        CHECK(description->index() == 3);
+        CHECK(chunk->at(1).offset_in_bits == 448000);
+        CHECK(chunk->at(1).stride_in_bits == 640);
+    }
+
+    SECTION("threshold")
+    {
+        /* With a threshold of 16 characters, `pkg_name` is stored out of line, too. */
+        MyOutOfLineRowLayoutFactory factory(16);
+        auto layout = factory.make(types);
+        auto chunk = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(chunk);
+        CHECK(chunk->num_tuples() == MyOutOfLineRowLayoutFactory::NUM_TUPLES_PER_CHUNK);
+        REQUIRE(chunk->num_children() == 3);
+        CHECK(chunk->at(0).stride_in_bits == 192);
+        CHECK(cast<const DataLayout::Leaf>(chunk->at(1).ptr.get())->index() == 2);
+        CHECK(cast<const DataLayout::Leaf>(chunk->at(2).ptr.get())->index() == 3);
+        CHECK(chunk->at(1).offset_in_bits % CACHE_LINE_SIZE_IN_BITS == 0);
+        CHECK(chunk->at(2).offset_in_bits == chunk->at(1).offset_in_bits + 256 * chunk->num_tuples());
+    }
+
+    SECTION("no wide attributes")
+    {
+        /* Without wide attributes, the layout is a chunk of rows as in the optimized row layout. */
+        MyOutOfLineRowLayoutFactory factory(80);
+        auto layout = factory.make(types, 10);
+        auto chunk = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(chunk);
+        REQUIRE(chunk->num_children() == 1);
+        CHECK(chunk->at(0).stride_in_bits == 1088); // 1077 bits, aligned to `size`
+    }
+}
+
+TEST_CASE("PAXLayout/aligned", "[milestone1]")
+{
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 4),
+        Type::Get_Char(Type::TY_Vector, 3),
+        Type::Get_Boolean(Type::TY_Vector),
+        Type::Get_Double(Type::TY_Vector),
+    };
+
+    SECTION("minipages start at cache lines")
+    {
+        MyPAXLayoutFactory factory(4096, /* aligned = */ true);
+        CHECK(factory.aligned());
+        auto layout = factory.make(types);
+        CHECK(layout.stride_in_bits() == 4096 * 8);
+
+        /* 262 tuples of 125 bits fit into a block, rounded down to the 64 lanes of the byte-sized `Boolean`. */
+        auto block = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(block);
+        const std::size_t num_tuples = block->num_tuples();
+        CHECK(num_tuples == 256);
+        REQUIRE(block->num_children() == types.size() + 1);
+
+        /* Every minipage starts at a cache line and ends before the next minipage or the end of the block. */
+        std::vector<std::pair<std::size_t, std::size_t>> minipages;
+        for (std::size_t idx = 0; idx != block->num_children(); ++idx) {
+            auto leaf = cast<const DataLayout::Leaf>(block->at(idx).ptr.get());
+            REQUIRE(leaf);
+            CHECK(leaf->index() == idx);
+            CHECK(block->at(idx).stride_in_bits == leaf->type()->size());
+            CHECK(block->at(idx).offset_in_bits % CACHE_LINE_SIZE_IN_BITS == 0);
+            minipages.emplace_back(block->at(idx).offset_in_bits,
+                                   block->at(idx).offset_in_bits + num_tuples * leaf->type()->size());
+        }
+        std::sort(minipages.begin(), minipages.end());
+        for (std::size_t i = 1; i != minipages.size(); ++i)
+            CHECK(minipages[i - 1].second <= minipages[i].first);
+        CHECK(minipages.back().second <= layout.stride_in_bits());
+    }
+
+    SECTION("block holds at least one lane")
+    {
+        /* 15 tuples of `a` and the NULL bitmap fit into 64 bytes, but the 16 lanes of `a` need another cache line. */
+        MyPAXLayoutFactory factory(64, /* aligned = */ true);
+        auto layout = factory.make({ Type::Get_Integer(Type::TY_Vector, 4) });
+        CHECK(layout.child().num_tuples() == 16);
+        CHECK(layout.stride_in_bits() == 1024);
+        auto block = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(block);
+        REQUIRE(block->num_children() == 2);
+        CHECK(block->at(0).offset_in_bits == 0);
+        CHECK(block->at(1).offset_in_bits == 512);
+    }
+
+    SECTION("unaligned layout is unchanged")
+    {
+        MyPAXLayoutFactory factory(4096);
+        CHECK_FALSE(factory.aligned());
+        auto layout = factory.make(types);
+        CHECK(layout.child().num_tuples() == 4096 * 8 / 125);
+    }
+}
+
+TEST_CASE("HugePagePAXLayout", "[milestone1]")
+{
+    SECTION("pages of sub-blocks")
+    {
+        MyHugePagePAXLayoutFactory factory;
+        CHECK(factory.sub_block_size_in_bytes() == 4096);
+        CHECK(factory.page_size_in_bytes() == 2 * 1024 * 1024);
+        auto layout = factory.make({ Type::Get_Integer(Type::TY_Vector, 4) });
+
+        /* Root must be an indefinite sequence of pages. */
+        CHECK(not layout.is_finite());
+        CHECK(layout.stride_in_bits() == 2 * 1024 * 1024 * 8);
+
+        /* Every tuple takes 32 bits for `a` and 1 bit for the NULL bitmap, and a page holds 512 sub-blocks. */
+        const std::size_t num_tuples = 4096 * 8 / 33;
+        auto page = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(page);
+        CHECK(page->num_tuples() == 512 * num_tuples);
+        REQUIRE(page->num_children() == 1);
+        CHECK(page->at(0).offset_in_bits == 0);
+        CHECK(page->at(0).stride_in_bits == 4096 * 8);
+
+        /* Every sub-block is a PAX block. */
+        auto sub_block = cast<const DataLayout::INode>(page->at(0).ptr.get());
+        REQUIRE(sub_block);
+        CHECK(sub_block->num_tuples() == num_tuples);
+        REQUIRE(sub_block->num_children() == 2);
+        CHECK(sub_block->at(0).offset_in_bits == 0);
+        CHECK(sub_block->at(0).stride_in_bits == 32);
+        CHECK(sub_block->at(1).offset_in_bits == num_tuples * 32);
+        CHECK(sub_block->at(1).stride_in_bits == 1);
+        CHECK(cast<const DataLayout::Leaf>(sub_block->at(1).ptr.get())->type()->is_bitmap());
+    }
+
+    SECTION("custom sizes")
+    {
+        MyHugePagePAXLayoutFactory factory(1024, 64 * 1024);
+        auto layout = factory.make({ Type::Get_Integer(Type::TY_Vector, 4) });
+        CHECK(layout.stride_in_bits() == 64 * 1024 * 8);
+        CHECK(layout.child().num_tuples() == 64 * (1024 * 8 / 33));
+    }
+
+    SECTION("page size must be a multiple of the sub-block size")
+    {
+        CHECK_THROWS_AS(MyHugePagePAXLayoutFactory(3000), std::invalid_argument);
+        CHECK_THROWS_AS(MyHugePagePAXLayoutFactory(0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("ColumnarLayout", "[milestone1]")
+{
+    MyColumnarLayoutFactory factory;
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 4),
+        Type::Get_Char(Type::TY_Vector, 3),
+        Type::Get_Boolean(Type::TY_Vector),
+        Type::Get_Double(Type::TY_Vector),
+    };
+
+    auto check_columns = [&types](const DataLayout &layout, std::size_t num_tuples) {
+        /* Root must be an indefinite sequence of blocks of columns. */
+        CHECK(not layout.is_finite());
+
+        auto &child_node = layout.child();
+        CHECK(child_node.num_tuples() == num_tuples);
+        auto inode = cast<const DataLayout::INode>(&child_node);
+        REQUIRE(inode);
+        REQUIRE(inode->num_children() == types.size() + 1);
+
+        /* Every column is contiguous, starts at a cache line, and follows its predecessor. */
+        std::size_t offset = 0;
+        for (std::size_t idx = 0; idx != inode->num_children(); ++idx) {
+            auto leaf = cast<const DataLayout::Leaf>(inode->at(idx).ptr.get());
+            REQUIRE(leaf);
+            CHECK(leaf->index() == idx);
+            CHECK(inode->at(idx).stride_in_bits == leaf->type()->size());
+            CHECK(inode->at(idx).offset_in_bits % CACHE_LINE_SIZE_IN_BITS == 0);
+            CHECK(inode->at(idx).offset_in_bits >= offset);
+            CHECK(inode->at(idx).offset_in_bits < offset + CACHE_LINE_SIZE_IN_BITS);
+            offset = inode->at(idx).offset_in_bits + num_tuples * leaf->type()->size();
+        }
+        CHECK(cast<const DataLayout::Leaf>(inode->at(types.size()).ptr.get())->type()->is_bitmap());
+        CHECK(layout.stride_in_bits() >= offset);
+        CHECK(layout.stride_in_bits() < offset + CACHE_LINE_SIZE_IN_BITS);
+    };
+
+    SECTION("known number of tuples")
+    {
+        auto layout = factory.make(types, 1000);
+        check_columns(layout, 1000);
+        auto inode = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(inode);
+        CHECK(inode->at(0).offset_in_bits == 0);
+        CHECK(inode->at(1).offset_in_bits == 32256); // 1000 * 32 bits, aligned to 512 bits
+        CHECK(inode->at(2).offset_in_bits == 56320); // + 1000 * 24 bits, aligned
+        CHECK(inode->at(3).offset_in_bits == 57344); // + 1000 * 1 bit, aligned
+    }
+
+    SECTION("unknown number of tuples")
+    {
+        check_columns(factory.make(types), MyColumnarLayoutFactory::NUM_TUPLES_PER_CHUNK);
+    }
+}
+
+TEST_CASE("ColumnGroupLayout", "[milestone1]")
+{
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 4),  // id
+        Type::Get_Char(Type::TY_Vector, 80),    // description
+        Type::Get_Integer(Type::TY_Vector, 8),  // size
+        Type::Get_Char(Type::TY_Vector, 32),    // pkg_name
+        Type::Get_Boolean(Type::TY_Vector),     // flag
+    };
+
+    SECTION("configured groups")
+    {
+        MyColumnGroupLayoutFactory factory({ { 0, 2, 3 } }, 4096);
+        auto layout = factory.make(types);
+
+        /* Root must be an indefinite sequence of blocks. */
+        CHECK(not layout.is_finite());
+        CHECK(layout.stride_in_bits() == 4096 * 8);
+
+        auto block = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(block);
+        /* The hot group, the group of the remaining attributes, and the NULL bitmap. */
+        REQUIRE(block->num_children() == 3);
+
+        /* The rows of the hot group hold `size`, `id` and `pkg_name`, in descending alignment. */
+        auto hot = cast<const DataLayout::INode>(block->at(0).ptr.get());
+        REQUIRE(hot);
+        CHECK(block->at(0).offset_in_bits == 0);
+        CHECK(block->at(0).stride_in_bits == 384);
+        CHECK(hot->num_tuples() == 1);
+        REQUIRE(hot->num_children() == 3);
+        CHECK(cast<const DataLayout::Leaf>(hot->at(0).ptr.get())->index() == 2);
+        CHECK(hot->at(0).offset_in_bits == 0);
+        CHECK(cast<const DataLayout::Leaf>(hot->at(1).ptr.get())->index() == 0);
+        CHECK(hot->at(1).offset_in_bits == 64);
+        CHECK(cast<const DataLayout::Leaf>(hot->at(2).ptr.get())->index() == 3);
+        CHECK(hot->at(2).offset_in_bits == 96);
+
+        /* The rows of the remaining attributes hold `description` and `flag`. */
+        auto cold = cast<const DataLayout::INode>(block->at(1).ptr.get());
+        REQUIRE(cold);
+        CHECK(block->at(1).stride_in_bits == 648);
+        REQUIRE(cold->num_children() == 2);
+        CHECK(cast<const DataLayout::Leaf>(cold->at(0).ptr.get())->index() == 1);
+        CHECK(cast<const DataLayout::Leaf>(cold->at(1).ptr.get())->index() == 4);
+        CHECK(cold->at(1).offset_in_bits == 640);
+
+        /* Every minipage starts at a cache line, and all minipages fit into the block. */
+        const std::size_t num_tuples = block->num_tuples();
+        CHECK(num_tuples == 30); // 31 tuples would not fit with the padding of the minipages
+        CHECK(block->at(1).offset_in_bits % 512 == 0);
+        CHECK(block->at(1).offset_in_bits >= 384 * num_tuples);
+        CHECK(block->at(2).offset_in_bits % 512 == 0);
+        CHECK(block->at(2).offset_in_bits >= block->at(1).offset_in_bits + 648 * num_tuples);
+        CHECK(block->at(2).stride_in_bits == 5);
+        CHECK(block->at(2).offset_in_bits + 5 * num_tuples <= layout.stride_in_bits());
+        auto null_bitmap = cast<const DataLayout::Leaf>(block->at(2).ptr.get());
+        REQUIRE(null_bitmap);
+        CHECK(null_bitmap->index() == 5);
+        CHECK(null_bitmap->type()->is_bitmap());
+    }
+
+    SECTION("attribute in two groups")
+    {
+        CHECK_THROWS_AS(MyColumnGroupLayoutFactory({ { 0, 1 }, { 1, 2 } }), std::invalid_argument);
+    }
+
+    SECTION("groups from workload")
+    {
+        std::istringstream in("SELECT id, pkg_name, size FROM packages WHERE size > 1024;\n"
+                              "SELECT pkg_name, size, id FROM packages;\n"
+                              "SELECT flag FROM packages;\n"
+                              "SELECT description FROM other;");
+        const auto workload = parse_workload(in);
+        auto factory = MyColumnGroupLayoutFactory::FromWorkload(workload, "packages",
+                                                                { "id", "description", "size", "pkg_name", "flag" });
+        REQUIRE(factory.groups().size() == 2);
+        CHECK(factory.groups()[0] == MyColumnGroupLayoutFactory::group_type{ 0, 2, 3 });
+        CHECK(factory.groups()[1] == MyColumnGroupLayoutFactory::group_type{ 4 });
+
+        /* `description` is accessed by no query of 'packages' and forms the group of the remaining attributes. */
+        auto layout = factory.make(types);
+        auto block = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(block);
+        REQUIRE(block->num_children() == 4);
+        auto cold = cast<const DataLayout::INode>(block->at(2).ptr.get());
+        REQUIRE(cold);
+        REQUIRE(cold->num_children() == 1);
+        CHECK(cast<const DataLayout::Leaf>(cold->at(0).ptr.get())->index() == 1);
+    }
+}
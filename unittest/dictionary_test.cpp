@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+
+#include "dictionary.hpp"
+#include <cstring>
+#include <map>
+#include <string>
+
+
+namespace {
+
+template<std::size_t N>
+std::array<char, N> make_value(const std::string &str)
+{
+    std::array<char, N> value{};
+    std::memcpy(value.data(), str.data(), std::min(N, str.size()));
+    return value;
+}
+
+}
+
+TEST_CASE("dictionary_column", "[milestone1]")
+{
+    SECTION("encode and decode")
+    {
+        const std::string repos[] = { "core", "extra", "community", "core", "multilib", "extra", "core" };
+        dictionary_column<10> column;
+        for (auto &repo : repos)
+            REQUIRE(column.append(make_value<10>(repo)));
+
+        REQUIRE(column.size() == 7);
+        CHECK(column.num_distinct() == 4);
+        for (std::size_t i = 0; i != column.size(); ++i)
+            CHECK(column[i] == make_value<10>(repos[i]));
+
+        /* Codes are assigned in the order values are first appended. */
+        CHECK(column.code(0) == 0);
+        CHECK(column.code(1) == 1);
+        CHECK(column.code(2) == 2);
+        CHECK(column.code(3) == 0);
+        CHECK(column.decode(3) == make_value<10>("multilib"));
+
+        CHECK(column.size_in_bytes() == 7 * 1 + 4 * 10);
+    }
+
+    SECTION("predicates and grouping")
+    {
+        dictionary_column<32, uint16_t> column;
+        std::map<std::string, std::size_t> expected;
+        for (std::size_t i = 0; i != 10000; ++i) {
+            const std::string packager = "packager " + std::to_string(i * 7 % 300);
+            REQUIRE(column.append(make_value<32>(packager)));
+            ++expected[packager];
+        }
+        CHECK(column.num_distinct() == 300);
+
+        CHECK(column.count_equal(make_value<32>("packager 42")) == expected["packager 42"]);
+        CHECK(column.count_equal(make_value<32>("nobody")) == 0);
+        CHECK_FALSE(column.find(make_value<32>("nobody")));
+
+        auto counts = column.count_by_code();
+        REQUIRE(counts.size() == 300);
+        for (std::size_t code = 0; code != counts.size(); ++code) {
+            const auto &value = column.decode(code);
+            CHECK(counts[code] == expected[std::string(value.data())]);
+        }
+    }
+
+    SECTION("full dictionary")
+    {
+        dictionary_column<4, uint8_t> column;
+        for (std::size_t i = 0; i != dictionary_column<4, uint8_t>::MAX_NUM_DISTINCT; ++i)
+            REQUIRE(column.append(make_value<4>(std::to_string(i))));
+        /* Existing values can still be appended, new ones cannot. */
+        CHECK(column.append(make_value<4>("0")));
+        CHECK_FALSE(column.append(make_value<4>("256")));
+        CHECK(column.size() == 257);
+        CHECK(column.num_distinct() == 256);
+    }
+}
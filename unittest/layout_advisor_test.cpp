@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+
+#include "data_layouts.hpp"
+#include "layout_advisor.hpp"
+#include <sstream>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("estimate_bytes_touched", "[milestone1]")
+{
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 8),
+        Type::Get_Char(Type::TY_Vector, 80),
+        Type::Get_Char(Type::TY_Vector, 48),
+    };
+    const std::size_t num_tuples = 10000;
+
+    SECTION("no attribute")
+    {
+        auto layout = MyColumnarLayoutFactory().make(types, num_tuples);
+        CHECK(estimate_bytes_touched(layout, { false, false, false }, num_tuples) == 0);
+        CHECK(estimate_bytes_touched(layout, { true, false, false }, 0) == 0);
+    }
+
+    SECTION("row layout")
+    {
+        /* Rows of 8 + 80 + 48 bytes and a NULL bitmap, padded to 144 bytes, touch 3 or 4 cache lines each. */
+        auto layout = MyOptimizedRowLayoutFactory().make(types, num_tuples);
+        const double all = estimate_bytes_touched(layout, { true, true, true }, num_tuples);
+        CHECK(all == Approx(144. * num_tuples).epsilon(.01));
+        /* A single attribute still touches at least one cache line per tuple. */
+        const double one = estimate_bytes_touched(layout, { true, false, false }, num_tuples);
+        CHECK(one >= 64. * num_tuples);
+        CHECK(one <= all);
+    }
+
+    SECTION("columnar layout")
+    {
+        /* A single column and the NULL bitmap touch only their own bytes. */
+        auto layout = MyColumnarLayoutFactory().make(types, num_tuples);
+        const double one = estimate_bytes_touched(layout, { true, false, false }, num_tuples);
+        CHECK(one == Approx(8. * num_tuples + 3. * num_tuples / 8).epsilon(.01));
+        const double all = estimate_bytes_touched(layout, { true, true, true }, num_tuples);
+        CHECK(all == Approx(136. * num_tuples + 3. * num_tuples / 8).epsilon(.01));
+    }
+
+    SECTION("extrapolation")
+    {
+        /* More tuples than sampled are extrapolated linearly. */
+        auto layout = MyPAXLayoutFactory(4096).make(types);
+        const std::size_t many = 10 * LAYOUT_ADVISOR_SAMPLE_TUPLES;
+        CHECK(estimate_bytes_touched(layout, { true, false, false }, many) ==
+              Approx(10 * estimate_bytes_touched(layout, { true, false, false }, LAYOUT_ADVISOR_SAMPLE_TUPLES)));
+    }
+}
+
+TEST_CASE("advise_layout", "[milestone1]")
+{
+    std::vector<const Type*> types = {
+        Type::Get_Integer(Type::TY_Vector, 4),
+        Type::Get_Char(Type::TY_Vector, 80),
+        Type::Get_Integer(Type::TY_Vector, 8),
+    };
+    const std::vector<std::string> attributes = { "id", "description", "size" };
+
+    MyOptimizedRowLayoutFactory row;
+    MyPAX4kLayoutFactory pax;
+    MyColumnarLayoutFactory columnar;
+    const std::vector<std::pair<std::string, const DataLayoutFactory*>> candidates = {
+        { "row_optimized", &row }, { "PAX4k", &pax }, { "columnar", &columnar },
+    };
+
+    SECTION("narrow scans prefer columns")
+    {
+        std::istringstream in("SELECT id, size FROM packages WHERE size > 1024; SELECT id FROM other;");
+        auto advice = advise_layout(candidates, parse_workload(in), "packages", attributes, types, 100000);
+        REQUIRE(advice.costs.size() == 3);
+        CHECK(advice.costs[0].name == "row_optimized");
+        CHECK(advice.costs[0].bytes_touched > advice.costs[1].bytes_touched);
+        CHECK(advice.choice().name != "row_optimized");
+    }
+
+    SECTION("no query of the table")
+    {
+        std::istringstream in("SELECT id FROM other;");
+        auto advice = advise_layout(candidates, parse_workload(in), "packages", attributes, types, 100000);
+        CHECK(advice.best == 0);
+        for (auto &cost : advice.costs)
+            CHECK(cost.bytes_touched == 0);
+    }
+
+    SECTION("no candidates")
+    {
+        CHECK_THROWS_AS(advise_layout({}, {}, "packages", attributes, types, 100), std::invalid_argument);
+    }
+}
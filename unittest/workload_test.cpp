@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+
+#include "workload.hpp"
+#include <sstream>
+
+
+TEST_CASE("parse_workload", "[milestone1]")
+{
+    SECTION("statements")
+    {
+        std::istringstream in("SELECT id FROM packages;\n\n  ;SELECT size\nFROM packages  ;\nSELECT 1 FROM T");
+        auto queries = parse_workload(in);
+        REQUIRE(queries.size() == 3);
+        CHECK(queries[0].sql == "SELECT id FROM packages");
+        CHECK(queries[1].sql == "SELECT size\nFROM packages");
+        CHECK(queries[2].sql == "SELECT 1 FROM T");
+    }
+
+    SECTION("identifiers")
+    {
+        std::istringstream in("SELECT id, pkg_name, size / 1024, \"MiB; description\" FROM packages -- licenses;\n"
+                              "WHERE size > 1024 * 1024 AND T0.fid_T1 = 'repo';");
+        auto queries = parse_workload(in);
+        REQUIRE(queries.size() == 1);
+        auto &query = queries[0];
+        for (const char *name : { "id", "pkg_name", "size", "packages", "T0", "fid_T1" })
+            CHECK(query.references(name));
+        /* Neither string literals nor comments reference identifiers. */
+        for (const char *name : { "MiB", "description", "licenses", "repo" })
+            CHECK_FALSE(query.references(name));
+        /* A multiplication does not select all attributes. */
+        CHECK_FALSE(query.selects_all);
+    }
+
+    SECTION("select all")
+    {
+        std::istringstream in("SELECT * FROM packages; SELECT COUNT(*) FROM packages; SELECT T.* FROM T;");
+        auto queries = parse_workload(in);
+        REQUIRE(queries.size() == 3);
+        CHECK(queries[0].selects_all);
+        CHECK_FALSE(queries[1].selects_all);
+        CHECK(queries[2].selects_all);
+    }
+
+    SECTION("accessed attributes")
+    {
+        std::istringstream in("SELECT id, size FROM packages; SELECT * FROM packages; SELECT id FROM other;");
+        auto queries = parse_workload(in);
+        REQUIRE(queries.size() == 3);
+        const std::vector<std::string> attributes = { "id", "pkg_name", "size" };
+        CHECK(queries[0].accessed_attributes("packages", attributes) == std::vector<bool>{ true, false, true });
+        CHECK(queries[1].accessed_attributes("packages", attributes) == std::vector<bool>{ true, true, true });
+        CHECK(queries[2].accessed_attributes("packages", attributes) == std::vector<bool>{ false, false, false });
+    }
+
+    SECTION("missing file")
+    {
+        CHECK_THROWS_AS(parse_workload_files({ "/nonexistent/workload.sql" }), std::runtime_error);
+    }
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "zone_map.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+TEST_CASE("zone_map", "[milestone1]")
+{
+    SECTION("zones")
+    {
+        const int64_t values[] = { 5, 3, 9, 7, 1, 2, 8 };
+        zone_map<int64_t> zm(3);
+        CHECK(zm.num_blocks() == 0);
+        for (int64_t v : values)
+            zm.append(v);
+
+        REQUIRE(zm.size() == 7);
+        REQUIRE(zm.num_blocks() == 3);
+        CHECK(zm.zones()[0].min == 3);
+        CHECK(zm.zones()[0].max == 9);
+        CHECK(zm.zones()[1].min == 1);
+        CHECK(zm.zones()[1].max == 7);
+        CHECK(zm.zones()[2].min == 8);
+        CHECK(zm.zones()[2].max == 8);
+
+        CHECK(zm.may_contain(0, 9, 100));
+        CHECK_FALSE(zm.may_contain(0, 10, 100));
+        CHECK(zm.may_contain(1, 0, 1));
+        CHECK_FALSE(zm.may_contain(2, 0, 7));
+        CHECK(zm.may_contain(2, 8, 8));
+    }
+
+    SECTION("scan skips blocks")
+    {
+        /* A clustered column: growing with the row, with some noise within a block. */
+        constexpr std::size_t NUM_TUPLES = 1000;
+        std::vector<int32_t> column;
+        zone_map<int32_t> zm(64);
+        for (std::size_t i = 0; i != NUM_TUPLES; ++i) {
+            column.push_back(int32_t(i) + (i % 7 == 0 ? 20 : 0));
+            zm.append(column.back());
+        }
+        REQUIRE(zm.num_blocks() == 16);
+
+        for (int32_t threshold : { -1, 0, 100, 500, 990, 1019, 1020, 5000 }) {
+            std::size_t expected = 0;
+            for (int32_t v : column)
+                expected += v > threshold;
+
+            std::size_t count = 0;
+            std::size_t num_scanned = 0;
+            std::vector<std::pair<std::size_t, std::size_t>> ranges;
+            const std::size_t num_skipped = zm.scan([threshold](auto &z) { return z.max > threshold; },
+                                                    [&](std::size_t first, std::size_t last) {
+                ranges.emplace_back(first, last);
+                ++num_scanned;
+                for (std::size_t i = first; i != last; ++i)
+                    count += column[i] > threshold;
+            });
+            CHECK(count == expected);
+            CHECK(num_skipped + num_scanned == zm.num_blocks());
+            for (auto [first, last] : ranges) {
+                CHECK(first % 64 == 0);
+                CHECK(last == std::min(first + 64, NUM_TUPLES));
+            }
+
+            /* Only blocks whose maximum exceeds the threshold are scanned. */
+            std::size_t expected_skipped = 0;
+            for (auto &z : zm.zones())
+                expected_skipped += z.max <= threshold;
+            CHECK(num_skipped == expected_skipped);
+        }
+
+        /* A selective predicate skips all but the last blocks. */
+        const auto num_skipped = zm.scan(950, 2000, [](std::size_t, std::size_t) { });
+        CHECK(num_skipped == 14);
+    }
+
+    SECTION("character sequences")
+    {
+        using value_type = std::array<char, 4>;
+        const value_type values[] = { {'b','a','r',0}, {'f','o','o',0}, {'q','u','x',0}, {'z','a','p',0} };
+        zone_map<value_type> zm(2);
+        for (auto &v : values)
+            zm.append(v);
+
+        REQUIRE(zm.num_blocks() == 2);
+        CHECK(zm.zones()[0].min == values[0]);
+        CHECK(zm.zones()[0].max == values[1]);
+        CHECK(zm.may_contain(0, value_type{'c',0,0,0}, value_type{'d',0,0,0}));
+        CHECK_FALSE(zm.may_contain(1, value_type{'c',0,0,0}, value_type{'d',0,0,0}));
+
+        std::size_t num_rows = 0;
+        const auto num_skipped = zm.scan(value_type{'r',0,0,0}, value_type{'z','z','z','z'},
+                                         [&](std::size_t first, std::size_t last) { num_rows += last - first; });
+        CHECK(num_skipped == 1);
+        CHECK(num_rows == 2);
+    }
+}